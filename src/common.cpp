@@ -3,6 +3,4 @@
 namespace NewBase
 {
 	HINSTANCE g_DllInstance{nullptr};
-	uint32_t g_LastPoolHash{};
-	std::unordered_map<void*, uint32_t> g_Pools{};
 }
\ No newline at end of file
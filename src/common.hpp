@@ -29,9 +29,6 @@ namespace NewBase
 	using namespace std::chrono_literals;
 
 	extern HINSTANCE g_DllInstance;
-	
-	extern uint32_t g_LastPoolHash;
-	extern std::unordered_map<void*, uint32_t> g_Pools;
 }
 
 // clang-format on
\ No newline at end of file
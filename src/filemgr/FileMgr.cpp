@@ -33,7 +33,7 @@ namespace NewBase
 		return folder;
 	}
 
-	const std::filesystem::path& FileMgr::EnsureFileCanBeCreated(const std::filesystem::path& file)
+	std::filesystem::path FileMgr::EnsureFileCanBeCreated(const std::filesystem::path& file)
 	{
 		return FileMgr::CreateFolderIfNotExists(file.parent_path());
 	}
@@ -44,7 +44,7 @@ namespace NewBase
 			throw std::invalid_argument("FileMgr::GetProjectFile expects a relative path.");
 
 		auto projFile = File(m_RootFolder / file);
-		EnsureFileCanBeCreated(file);
+		EnsureFileCanBeCreated(projFile.Path());
 
 		return projFile;
 	}
@@ -8,6 +8,7 @@ namespace NewBase
 	    m_Name(name),
 	    m_Enabled(false)
 	{
+		std::lock_guard lock(m_HooksMutex);
 		m_Hooks.emplace_back(this);
 	}
 
@@ -18,6 +19,7 @@ namespace NewBase
 
 	void BaseHook::EnableAll()
 	{
+		std::lock_guard lock(m_HooksMutex);
 		for (auto hook : m_Hooks)
 		{
 			hook->Enable();
@@ -26,6 +28,7 @@ namespace NewBase
 
 	void BaseHook::DisableAll()
 	{
+		std::lock_guard lock(m_HooksMutex);
 		for (auto hook : m_Hooks)
 		{
 			hook->Disable();
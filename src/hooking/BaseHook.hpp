@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <string_view>
 
 namespace NewBase
@@ -46,6 +47,7 @@ namespace NewBase
 
 	private:
 		inline static std::vector<BaseHook*> m_Hooks;
+		inline static std::mutex m_HooksMutex; // hooks on lazily resolved targets are created off the main thread
 		
 	};
 
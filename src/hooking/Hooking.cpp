@@ -8,14 +8,30 @@
 
 namespace NewBase
 {
-	Hooking::Hooking()
+	struct DetourTarget
+	{
+		std::string_view m_Name;
+		PVOID PointerData::*m_Pointer;
+		void (*m_Create)(const std::string_view name, PVOID target);
+	};
+
+	template<auto Detour>
+	static void CreateDetour(const std::string_view name, PVOID target)
+	{
+		BaseHook::Add<Detour>(new DetourHook(name, target, Detour));
+	}
+
+	static constexpr std::array<DetourTarget, 4> s_Detours = {{
+	    {"SMPACreateStub", &PointerData::m_SMPACreateStub, CreateDetour<Allocator::SMPACreateStub>},
+	    {"ReadGameConfig", &PointerData::m_ReadGameConfig, CreateDetour<GameFiles::ReadGameConfig>},
+	    {"GetPoolSize", &PointerData::m_GetPoolSize, CreateDetour<Pools::GetPoolSize>},
+	    {"CreatePool", &PointerData::m_CreatePool, CreateDetour<Pools::CreatePool>},
+	}};
+
+	Hooking::Hooking() :
+	    m_Prepared(0)
 	{
 		// BaseHook::Add<Anticheat::QueueDependency>(new DetourHook("QueueDependency", Pointers.m_QueueDependency, Anticheat::QueueDependency));
-		BaseHook::Add<Allocator::SMPACreateStub>(new DetourHook("SMPACreateStub", Pointers.m_SMPACreateStub, Allocator::SMPACreateStub));
-		BaseHook::Add<GameFiles::ReadGameConfig>(new DetourHook("ReadGameConfig", Pointers.m_ReadGameConfig, GameFiles::ReadGameConfig));
-		BaseHook::Add<Pools::GetPoolSize>(new DetourHook("GetPoolSize", Pointers.m_GetPoolSize, Pools::GetPoolSize));
-		BaseHook::Add<Pools::CreatePool>(new DetourHook("CreatePool", Pointers.m_CreatePool, Pools::CreatePool));
-		BaseHook::Add<Pools::GetPoolItem>(new DetourHook("GetPoolItem", Pointers.m_GetPoolItem, Pools::GetPoolItem));
 	}
 
 	Hooking::~Hooking()
@@ -33,16 +49,79 @@ namespace NewBase
 		GetInstance().DestroyImpl();
 	}
 
+	void Hooking::Prepare(PVOID PointerData::*pointer)
+	{
+		GetInstance().PrepareImpl(pointer);
+	}
+
 	bool Hooking::InitImpl()
 	{
+		// whatever was not streamed in while scanning, the hook set has to be complete before the batch enable
+		for (const auto& detour : s_Detours)
+			PrepareImpl(detour.m_Pointer);
+
+		if (m_PrepareError)
+			std::rethrow_exception(m_PrepareError);
+
 		BaseHook::EnableAll();
 		m_MinHook.ApplyQueued();
 
+		m_LazyHooks = std::async(std::launch::async, &Hooking::InitLazyImpl, this);
+
 		return true;
 	}
 
+	void Hooking::PrepareImpl(PVOID PointerData::*pointer)
+	{
+		for (std::size_t i = 0; i < s_Detours.size(); ++i)
+		{
+			if (s_Detours[i].m_Pointer != pointer)
+				continue;
+
+			if (m_Prepared.fetch_or(1u << i) & (1u << i))
+				return;
+
+			try
+			{
+				s_Detours[i].m_Create(s_Detours[i].m_Name, Pointers.*pointer);
+			}
+			catch (const std::exception&)
+			{
+				std::lock_guard lock(m_PrepareMutex);
+				if (!m_PrepareError)
+					m_PrepareError = std::current_exception();
+			}
+			return;
+		}
+	}
+
+	void Hooking::InitLazyImpl()
+	{
+		// targets that come from LazyPointers, waiting for them here keeps the scan off the boot path
+		try
+		{
+			if (const auto getPoolItem = Pointers.m_GetPoolItem.Get())
+			{
+				const auto hook = new DetourHook("GetPoolItem", getPoolItem, Pools::GetPoolItem);
+				BaseHook::Add<Pools::GetPoolItem>(hook);
+				hook->EnableNow();
+			}
+			else
+			{
+				LOG(WARNING) << "Not hooking GetPoolItem, its pointer could not be resolved.";
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LOG(FATAL) << e.what();
+		}
+	}
+
 	void Hooking::DestroyImpl()
 	{
+		if (m_LazyHooks.valid())
+			m_LazyHooks.wait();
+
 		BaseHook::DisableAll();
 		m_MinHook.ApplyQueued();
 
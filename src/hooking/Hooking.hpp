@@ -1,14 +1,25 @@
 #pragma once
 #include "MinHook.hpp"
 
+#include <atomic>
+#include <exception>
+#include <future>
+#include <mutex>
+
 namespace NewBase
 {
+	struct PointerData;
+
 	class Hooking
 	{
 	private:
 		Hooking();
 
 		MinHook m_MinHook;
+		std::future<void> m_LazyHooks;
+		std::atomic<std::uint32_t> m_Prepared; // one bit per detour whose hook already exists
+		std::exception_ptr m_PrepareError;
+		std::mutex m_PrepareMutex;
 		
 	public:
 		virtual ~Hooking();
@@ -20,8 +31,16 @@ namespace NewBase
 		static bool Init();
 		static void Destroy();
 
+		/**
+		 * @brief Creates the hook on a pointer right after it has been resolved, meant to be handed to Pointers::Init.
+		 * Safe to call from the scanning threads, Init only creates what is still missing before enabling everything in one batch.
+		 */
+		static void Prepare(void* PointerData::*pointer);
+
 	private:
 		bool InitImpl();
+		void PrepareImpl(void* PointerData::*pointer);
+		void InitLazyImpl();
 		void DestroyImpl();
 
 	private:
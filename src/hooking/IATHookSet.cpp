@@ -0,0 +1,65 @@
+#include "IATHookSet.hpp"
+
+#include <algorithm>
+
+namespace NewBase
+{
+	IATHookSet::IATHookSet(const std::string_view name, Module* module) :
+	    BaseHook(name),
+	    m_Module(module)
+	{
+	}
+
+	IATHookSet::~IATHookSet()
+	{
+		Disable();
+	}
+
+	bool IATHookSet::Enable()
+	{
+		if (m_Enabled)
+			return false;
+
+		// a page that cannot be unprotected is skipped, Disable still has to restore the others
+		m_Enabled = true;
+		return Write(true);
+	}
+
+	bool IATHookSet::Disable()
+	{
+		if (!m_Enabled)
+			return false;
+
+		m_Enabled = false;
+		return Write(false);
+	}
+
+	bool IATHookSet::Write(bool hooked)
+	{
+		std::ranges::sort(m_Entries, {}, &Entry::m_Slot);
+
+		bool written = true;
+		for (auto entry = m_Entries.begin(); entry != m_Entries.end();)
+		{
+			const auto page = reinterpret_cast<std::uintptr_t>(entry->m_Slot) & ~(s_PageSize - 1);
+			const auto end  = std::find_if(entry, m_Entries.end(), [page](const Entry& other) {
+				return (reinterpret_cast<std::uintptr_t>(other.m_Slot) & ~(s_PageSize - 1)) != page;
+			});
+
+			DWORD oldProtect;
+			if (!VirtualProtect(reinterpret_cast<void*>(page), s_PageSize, PAGE_EXECUTE_READWRITE, &oldProtect)) // we load before Arxan does that
+			{
+				LOG(WARNING) << Name() << ": cannot unprotect the IAT page at " << HEX(page);
+				written = false;
+				entry   = end;
+				continue;
+			}
+
+			for (; entry != end; ++entry)
+				*entry->m_Slot = hooked ? entry->m_Detour : entry->m_Original;
+
+			VirtualProtect(reinterpret_cast<void*>(page), s_PageSize, oldProtect, &oldProtect); // restore old page protection to avoid tripping Arxan when it finally loads
+		}
+		return written;
+	}
+}
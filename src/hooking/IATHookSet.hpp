@@ -0,0 +1,78 @@
+#pragma once
+#include "BaseHook.hpp"
+#include "memory/Module.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace NewBase
+{
+	/**
+	 * @brief Hooks any amount of imports of one module as a single hook.
+	 *
+	 * Enabling and disabling swap every IAT slot in one pass, each page the slots live on is reprotected once
+	 * instead of once per import like separate IATHooks would.
+	 */
+	class IATHookSet : public BaseHook
+	{
+	private:
+		struct Entry
+		{
+			void** m_Slot;
+			void* m_Original;
+			void* m_Detour;
+		};
+
+		Module* m_Module;
+		std::vector<Entry> m_Entries;
+		std::unordered_map<void*, void*> m_Originals; // detour to the function it replaces
+
+		static constexpr std::uintptr_t s_PageSize = 0x1000;
+
+	public:
+		IATHookSet(const std::string_view name, Module* module);
+		virtual ~IATHookSet();
+
+		/**
+		 * @brief Adds an import to the set, only takes effect on the next Enable.
+		 *
+		 * @return false If the module does not import the function
+		 */
+		template<typename T>
+		bool Add(const std::string_view library, const std::string_view import, T detour);
+
+		virtual bool Enable() override;
+		virtual bool Disable() override;
+
+		/**
+		 * @brief The imported function detour stands in for.
+		 */
+		template<typename T>
+		T Original(T detour) const;
+
+	private:
+		bool Write(bool hooked);
+	};
+
+	template<typename T>
+	inline bool IATHookSet::Add(const std::string_view library, const std::string_view import, T detour)
+	{
+		const auto slot = m_Module->GetImport(library, import);
+		if (!slot)
+		{
+			LOG(WARNING) << Name() << ": " << m_Module->Name() << " does not import " << library << "!" << import;
+			return false;
+		}
+
+		m_Entries.push_back({slot, *slot, reinterpret_cast<void*>(detour)});
+		m_Originals.emplace(reinterpret_cast<void*>(detour), *slot);
+		return true;
+	}
+
+	template<typename T>
+	inline T IATHookSet::Original(T detour) const
+	{
+		const auto it = m_Originals.find(reinterpret_cast<void*>(detour));
+		return it != m_Originals.end() ? reinterpret_cast<T>(it->second) : nullptr;
+	}
+}
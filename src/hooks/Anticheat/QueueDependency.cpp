@@ -1,50 +1,29 @@
 #include "hooking/DetourHook.hpp"
 #include "hooks/Hooks.hpp"
+#include "memory/ModuleMgr.hpp"
+#include "util/Joaat.hpp"
 
-#include <Psapi.h>
+#include <algorithm>
 
 namespace NewBase
 {
-	bool inline is_address_in_game_region(uint64_t address)
-	{
-		static uint64_t moduleBase = NULL;
-		static uint64_t moduleSize = NULL;
-		if ((!moduleBase) || (!moduleSize))
-		{
-			MODULEINFO info;
-			if (!GetModuleInformation(GetCurrentProcess(), GetModuleHandle(0), &info, sizeof(info)))
-			{
-				LOG(FATAL) << "GetModuleInformation failed!";
-				return true;
-			}
-			else
-			{
-				moduleBase = (uint64_t)GetModuleHandle(0);
-				moduleSize = (uint64_t)info.SizeOfImage;
-			}
-		}
-		return address > moduleBase && address < (moduleBase + moduleSize);
-	}
-
-	bool is_jump(__int64 fptr)
-	{
-		if (!is_address_in_game_region(fptr))
-			return false;
-
-		auto value = *(uint8_t*)(fptr);
-		return value == 0xE9;
-	}
-
 	bool is_unwanted_dependency(__int64 cb)
 	{
-		auto f1 = *(__int64*)(cb + 0x60);
-		auto f2 = *(__int64*)(cb + 0x100);
-		auto f3 = *(__int64*)(cb + 0x1A0);
+		static const auto game = ModuleMgr::Get("GTA5.exe"_J);
 
-		if (!is_address_in_game_region(f1) || !is_address_in_game_region(f2) || !is_address_in_game_region(f3))
-			return false;
+		const std::array<std::uintptr_t, 3> functions = {*(std::uintptr_t*)(cb + 0x60), *(std::uintptr_t*)(cb + 0x100), *(std::uintptr_t*)(cb + 0x1A0)};
+		std::array<AddressOwner, 3> owners;
+		ModuleMgr::Addresses().Find(functions, owners);
+
+		for (const auto& owner : owners)
+		{
+			if (!game || owner.m_Module != game)
+				return false;
+		}
 
-		return is_jump(f1) || is_jump(f2) || is_jump(f3);
+		return std::ranges::any_of(functions, [](std::uintptr_t function) {
+			return *(uint8_t*)(function) == 0xE9;
+		});
 	}
 
 	void Anticheat::QueueDependency(void* dependency)
@@ -1,13 +1,13 @@
 #include "hooking/DetourHook.hpp"
 #include "hooks/Hooks.hpp"
-#include "util/Joaat.hpp"
+#include "memory/PoolRegistry.hpp"
 
 namespace NewBase
 {
 	void* Pools::CreatePool(void* pool, int size, const char* name, int unk1, int unk2, bool unk3)
 	{
 		BaseHook::Get<Pools::CreatePool, DetourHook<decltype(&Pools::CreatePool)>>()->Original()(pool, size, name, unk1, unk2, unk3);
-		g_Pools.insert({pool, g_LastPoolHash});
+		PoolRegistry::Add(static_cast<const PoolHeader*>(pool), name);
 		return pool;
 	}
 }
\ No newline at end of file
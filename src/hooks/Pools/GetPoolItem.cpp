@@ -1,6 +1,6 @@
 #include "hooking/DetourHook.hpp"
 #include "hooks/Hooks.hpp"
-#include "util/Joaat.hpp"
+#include "memory/PoolRegistry.hpp"
 
 namespace NewBase
 {
@@ -8,14 +8,17 @@ namespace NewBase
 	{
 		auto item = BaseHook::Get<Pools::GetPoolItem, DetourHook<decltype(&Pools::GetPoolItem)>>()->Original()(pool);
 
+		const auto info = PoolRegistry::Find(pool);
+		if (info)
+			info->m_Counters->Count(item != nullptr);
+
 		if (item)
 			return item;
 
-		if (g_Pools.count(pool))
+		if (info)
 		{
-			auto hash = g_Pools[pool];
 			std::ostringstream message;
-			message << "ERROR: POOL 0x" << std::hex << std::uppercase << hash << " FULL!";
+			message << "ERROR: POOL 0x" << std::hex << std::uppercase << info->m_Hash << " FULL!";
 			MessageBoxA(0, message.str().c_str(), "YimASI", MB_ICONSTOP | MB_SYSTEMMODAL | MB_TOPMOST | MB_SETFOREGROUND); // inspired by FiveM
 		}
 
@@ -1,10 +1,11 @@
 #include "hooking/DetourHook.hpp"
 #include "hooks/Hooks.hpp"
-#include "util/Joaat.hpp"
+#include "memory/PoolRegistry.hpp"
+#include "util/PerfectHashMap.hpp"
 
 namespace NewBase
 {
-	static const std::unordered_map<uint32_t, unsigned int> s_PoolSizeOverrides = {
+	static constexpr auto s_PoolSizeOverrides = MakePerfectHashMap<unsigned int>({
 	    {"CEventNetwork"_J, 5000},      //  // allow 10x events to be stored
 	    {"Decorator"_J, 1400},          //      // try to prevent decorator crashes
 	    {"FragmentStore"_J, 50000},    //  // .yft files
@@ -21,20 +22,19 @@ namespace NewBase
 	    {"ScenarioPointWorld"_J, 2800}, //  // map mods
 	    {"MaxNonRegionScenarioPointSpatialObjects"_J, 1800}, //  // map mods
 	    {"Object"_J, 3000},                                  //
-	};
+	});
 
 	unsigned int Pools::GetPoolSize(rage::fwConfigManagerImpl<CGameConfig>* manager, uint32_t hash, int defaultValue)
 	{
-		g_LastPoolHash = hash;
-
 		auto value = BaseHook::Get<Pools::GetPoolSize, DetourHook<decltype(&Pools::GetPoolSize)>>()->Original()(manager, hash, defaultValue);
 
-		if (s_PoolSizeOverrides.count(hash))
+		if (const auto size = s_PoolSizeOverrides.Find(hash))
 		{
-			LOG(VERBOSE) << __FUNCTION__ ": " << HEX(hash) << ": " << value << " -> " << s_PoolSizeOverrides.at(hash);
-			return s_PoolSizeOverrides.at(hash);
+			LOG(VERBOSE) << __FUNCTION__ ": " << HEX(hash) << ": " << value << " -> " << *size;
+			value = *size;
 		}
 
+		PoolRegistry::SetPendingSize(hash, value);
 		return value;
 	}
 }
\ No newline at end of file
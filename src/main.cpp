@@ -4,6 +4,8 @@
 #include "filemgr/FileMgr.hpp"
 #include "hooking/Hooking.hpp"
 #include "memory/ModuleMgr.hpp"
+#include "memory/PebModuleProvider.hpp"
+#include "memory/PoolTelemetry.hpp"
 #include "pointers/Pointers.hpp"
 
 namespace NewBase
@@ -18,9 +20,11 @@ namespace NewBase
 
 		try
 		{
-			if (Pointers.Init())
+			// hooks are created while the remaining patterns are still being scanned for
+			if (Pointers.Init(&Hooking::Prepare))
 			{
 				Hooking::Init();
+				PoolTelemetry::Init(FileMgr::GetProjectFile("./pools.csv").Path());
 				AsiLoader::Init();
 			}
 		}
@@ -31,7 +35,7 @@ namespace NewBase
 	}
 }
 
-BOOL WINAPI DllMain(HINSTANCE dllInstance, DWORD reason, void*)
+BOOL WINAPI DllMain(HINSTANCE dllInstance, DWORD reason, void* reserved)
 {
 	using namespace NewBase;
 
@@ -39,10 +43,15 @@ BOOL WINAPI DllMain(HINSTANCE dllInstance, DWORD reason, void*)
 
 	if (reason == DLL_PROCESS_ATTACH)
 	{
-		ModuleMgr::Init();
+		ModuleMgr::Init(std::make_unique<PebModuleProvider>());
 		Hijack::Init(&Main);
 
 		g_DllInstance = dllInstance;
 	}
+	else if (reason == DLL_PROCESS_DETACH && reserved)
+	{
+		// the process is exiting, stopped here before the static destructors run rather than by one of them
+		PoolTelemetry::Destroy();
+	}
 	return true;
 }
\ No newline at end of file
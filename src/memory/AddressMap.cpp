@@ -0,0 +1,81 @@
+#include "AddressMap.hpp"
+
+#include <algorithm>
+
+namespace NewBase
+{
+	AddressMap::AddressMap() :
+	    m_Firsts(),
+	    m_Blocks(),
+	    m_Ends(),
+	    m_Owners(),
+	    m_Count(0)
+	{
+	}
+
+	AddressMap::AddressMap(std::span<const Module* const> modules) :
+	    AddressMap()
+	{
+		struct Range
+		{
+			std::uintptr_t m_Start;
+			std::uintptr_t m_End;
+			AddressOwner m_Owner;
+		};
+
+		std::vector<Range> ranges;
+		for (const auto module : modules)
+		{
+			if (!module || !module->Valid())
+				continue;
+
+			// every range runs up to the next section so padding between sections still belongs to the module
+			auto start              = module->Base();
+			const ModuleSection* at = nullptr;
+			for (const auto& section : module->Sections())
+			{
+				const auto sectionStart = module->Base() + section.m_Rva;
+				if (sectionStart > start)
+					ranges.push_back({start, sectionStart, {module, at}});
+
+				start = std::max(start, sectionStart);
+				at    = &section;
+			}
+			if (module->End() > start)
+				ranges.push_back({start, module->End(), {module, at}});
+		}
+		std::ranges::sort(ranges, {}, &Range::m_Start);
+
+		// overlapping images cannot be mapped, but a broken header should not make lookups wrong for everything else
+		std::vector<Range> disjoint;
+		for (const auto& range : ranges)
+		{
+			if (!disjoint.empty() && range.m_Start < disjoint.back().m_End)
+				continue;
+			disjoint.push_back(range);
+		}
+
+		m_Count = disjoint.size();
+		m_Blocks.resize((m_Count + s_BlockSize - 1) / s_BlockSize);
+		if (!m_Blocks.empty())
+			std::ranges::fill(m_Blocks.back().m_Starts, UINTPTR_MAX);
+		m_Ends.reserve(m_Count);
+		m_Owners.reserve(m_Count);
+
+		for (std::size_t i = 0; i < m_Count; ++i)
+		{
+			if (i % s_BlockSize == 0)
+				m_Firsts.push_back(disjoint[i].m_Start);
+			m_Blocks[i / s_BlockSize].m_Starts[i % s_BlockSize] = disjoint[i].m_Start;
+			m_Ends.push_back(disjoint[i].m_End);
+			m_Owners.push_back(disjoint[i].m_Owner);
+		}
+	}
+
+	void AddressMap::Find(std::span<const std::uintptr_t> addresses, std::span<AddressOwner> owners) const
+	{
+		// independent searches, the CPU overlaps their loads instead of waiting on one chain at a time
+		for (std::size_t i = 0; i < addresses.size() && i < owners.size(); ++i)
+			owners[i] = Find(addresses[i]);
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "Module.hpp"
+
+#include <span>
+#include <vector>
+
+namespace NewBase
+{
+	struct AddressOwner
+	{
+		const Module* m_Module;         // nullptr if no known module maps the address
+		const ModuleSection* m_Section; // nullptr for the headers and for unowned addresses
+
+		explicit operator bool() const
+		{
+			return m_Module;
+		}
+	};
+
+	/**
+	 * @brief Immutable table of every module range split at its sections, answers which module and section own an address.
+	 *
+	 * Range starts are packed eight to a cache line. A lookup binary searches the first start of every line, then counts
+	 * the starts below the address in the one line it landed on, both without branches, so it touches two or three lines
+	 * even with hundreds of modules loaded. ModuleMgr builds one per snapshot, which makes lookups safe from any thread
+	 * without locking.
+	 */
+	class AddressMap
+	{
+	private:
+		static constexpr std::size_t s_BlockSize = 8;
+
+		struct alignas(64) StartBlock
+		{
+			std::uintptr_t m_Starts[s_BlockSize];
+		};
+
+		std::vector<std::uintptr_t> m_Firsts; // first start of every block, small enough to stay in L1
+		std::vector<StartBlock> m_Blocks;     // unused slots of the last block hold UINTPTR_MAX
+		std::vector<std::uintptr_t> m_Ends;
+		std::vector<AddressOwner> m_Owners;
+		std::size_t m_Count;
+
+	public:
+		AddressMap();
+		explicit AddressMap(std::span<const Module* const> modules);
+
+		AddressOwner Find(std::uintptr_t address) const
+		{
+			const auto index = Index(address);
+			return index < m_Count ? m_Owners[index] : AddressOwner{};
+		}
+
+		/**
+		 * @brief Classifies a whole array at once, owners has to be at least as long as addresses.
+		 */
+		void Find(std::span<const std::uintptr_t> addresses, std::span<AddressOwner> owners) const;
+
+		bool Contains(const Module* module, std::uintptr_t address) const
+		{
+			return Find(address).m_Module == module;
+		}
+
+		std::size_t Size() const
+		{
+			return m_Count;
+		}
+
+	private:
+		/**
+		 * @brief Range holding the address, m_Count if there is none.
+		 */
+		std::size_t Index(std::uintptr_t address) const
+		{
+			if (!m_Count || address < m_Firsts[0])
+				return m_Count;
+
+			// the comparison picks the half without a branch, the compiler turns it into a conditional move
+			std::size_t block = 0;
+			for (auto length = m_Firsts.size(); length > 1; length -= length / 2)
+			{
+				const auto half = length / 2;
+				block           = m_Firsts[block + half] <= address ? block + half : block;
+			}
+
+			std::size_t below = 0;
+			for (const auto start : m_Blocks[block].m_Starts)
+				below += start <= address;
+
+			const auto index = block * s_BlockSize + below - 1;
+			return index < m_Count && address < m_Ends[index] ? index : m_Count;
+		}
+	};
+}
@@ -0,0 +1,291 @@
+#include "InstructionDecoder.hpp"
+
+#include <array>
+
+namespace NewBase
+{
+	struct Operand
+	{
+		static constexpr std::uint8_t None    = 0;
+		static constexpr std::uint8_t ModRm   = 1 << 0;
+		static constexpr std::uint8_t Imm8    = 1 << 1;
+		static constexpr std::uint8_t Imm16   = 1 << 2;
+		static constexpr std::uint8_t ImmZ    = 1 << 3; // 32 bits, 16 with an operand size prefix
+		static constexpr std::uint8_t Rel8    = 1 << 4;
+		static constexpr std::uint8_t Rel32   = 1 << 5;
+		static constexpr std::uint8_t Special = 1 << 6; // operands depend on more than the opcode, handled in Decode
+		static constexpr std::uint8_t Invalid = 1 << 7;
+	};
+
+	static constexpr std::array<std::uint8_t, 256> s_OneByte = [] {
+		std::array<std::uint8_t, 256> table{};
+
+		// the eight classic ALU groups share one layout: r/m forms, then AL/eAX with an immediate
+		for (int op = 0x00; op < 0x40; op += 8)
+		{
+			for (int i = 0; i < 4; ++i)
+				table[op + i] = Operand::ModRm;
+			table[op + 4] = Operand::Imm8;
+			table[op + 5] = Operand::ImmZ;
+			table[op + 6] = Operand::Invalid;
+			table[op + 7] = Operand::Invalid;
+		}
+		// two byte opcodes, segment prefixes and REX are consumed before the table is consulted
+		table[0x0F] = Operand::Special;
+		for (const auto prefix : {0x26, 0x2E, 0x36, 0x3E})
+			table[prefix] = Operand::Special;
+		for (int op = 0x40; op < 0x60; ++op)
+			table[op] = op < 0x50 ? Operand::Special : Operand::None;
+		table[0x60] = table[0x61] = Operand::Invalid;
+		table[0x62]               = Operand::Special; // EVEX
+		table[0x63]               = Operand::ModRm;
+		table[0x64] = table[0x65] = table[0x66] = table[0x67] = Operand::Special;
+		table[0x68]               = Operand::ImmZ;
+		table[0x69]               = Operand::ModRm | Operand::ImmZ;
+		table[0x6A]               = Operand::Imm8;
+		table[0x6B]               = Operand::ModRm | Operand::Imm8;
+		for (int op = 0x70; op < 0x80; ++op)
+			table[op] = Operand::Rel8;
+		table[0x80] = Operand::ModRm | Operand::Imm8;
+		table[0x81] = Operand::ModRm | Operand::ImmZ;
+		table[0x82] = Operand::Invalid;
+		table[0x83] = Operand::ModRm | Operand::Imm8;
+		for (int op = 0x84; op < 0x90; ++op)
+			table[op] = Operand::ModRm;
+		table[0x9A] = Operand::Invalid;
+		for (int op = 0xA0; op < 0xA4; ++op)
+			table[op] = Operand::Special; // moffs
+		table[0xA8] = Operand::Imm8;
+		table[0xA9] = Operand::ImmZ;
+		for (int op = 0xB0; op < 0xB8; ++op)
+			table[op] = Operand::Imm8;
+		for (int op = 0xB8; op < 0xC0; ++op)
+			table[op] = Operand::Special; // imm64 with REX.W
+		table[0xC0] = table[0xC1] = Operand::ModRm | Operand::Imm8;
+		table[0xC2]               = Operand::Imm16;
+		table[0xC4] = table[0xC5] = Operand::Special; // VEX
+		table[0xC6]               = Operand::ModRm | Operand::Imm8;
+		table[0xC7]               = Operand::ModRm | Operand::ImmZ;
+		table[0xC8]               = Operand::Special; // enter imm16, imm8
+		table[0xCA]               = Operand::Imm16;
+		table[0xCD]               = Operand::Imm8;
+		table[0xCE]               = Operand::Invalid;
+		for (int op = 0xD0; op < 0xD4; ++op)
+			table[op] = Operand::ModRm;
+		table[0xD4] = table[0xD5] = table[0xD6] = Operand::Invalid;
+		for (int op = 0xD8; op < 0xE0; ++op)
+			table[op] = Operand::ModRm;
+		for (int op = 0xE0; op < 0xE4; ++op)
+			table[op] = Operand::Rel8;
+		for (int op = 0xE4; op < 0xE8; ++op)
+			table[op] = Operand::Imm8;
+		table[0xE8] = table[0xE9] = Operand::Rel32;
+		table[0xEA]               = Operand::Invalid;
+		table[0xEB]               = Operand::Rel8;
+		table[0xF0] = table[0xF2] = table[0xF3] = Operand::Special;
+		table[0xF6] = table[0xF7] = Operand::Special; // test has an immediate, the rest of the group does not
+		table[0xFE] = table[0xFF] = Operand::ModRm;
+		return table;
+	}();
+
+	static constexpr std::array<std::uint8_t, 256> s_TwoByte = [] {
+		std::array<std::uint8_t, 256> table{};
+		table.fill(Operand::ModRm);
+
+		for (const auto op : {0x04, 0x0A, 0x0C, 0x0E, 0x0F, 0x24, 0x25, 0x26, 0x27, 0x36, 0x39, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F, 0x7A, 0x7B})
+			table[op] = Operand::Invalid;
+		for (const auto op : {0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x37, 0x77, 0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA})
+			table[op] = Operand::None;
+		table[0x38] = table[0x3A] = Operand::Special; // three byte opcodes
+		for (int op = 0x70; op < 0x74; ++op)
+			table[op] = Operand::ModRm | Operand::Imm8;
+		for (int op = 0x80; op < 0x90; ++op)
+			table[op] = Operand::Rel32;
+		for (const auto op : {0xA4, 0xAC, 0xBA, 0xC2, 0xC4, 0xC5, 0xC6})
+			table[op] = Operand::ModRm | Operand::Imm8;
+		for (int op = 0xC8; op < 0xD0; ++op)
+			table[op] = Operand::None; // bswap
+		return table;
+	}();
+
+	/**
+	 * @brief Length of the ModRM byte and everything that hangs off it, records the offset of a RIP relative disp32.
+	 */
+	static std::optional<std::size_t> ModRmLength(std::span<const std::uint8_t> code, std::size_t at, std::uint8_t& relative)
+	{
+		if (at >= code.size())
+			return std::nullopt;
+
+		const auto modrm = code[at];
+		const auto mod   = modrm >> 6;
+		const auto rm    = modrm & 7;
+
+		std::size_t length = 1;
+		if (mod == 3)
+			return length;
+
+		if (rm == 4)
+		{
+			if (at + 1 >= code.size())
+				return std::nullopt;
+
+			length++;
+			if (mod == 0 && (code[at + 1] & 7) == 5)
+				length += 4;
+		}
+		else if (mod == 0 && rm == 5)
+		{
+			relative = static_cast<std::uint8_t>(at + 1);
+			length += 4;
+		}
+
+		if (mod == 1)
+			length += 1;
+		else if (mod == 2)
+			length += 4;
+		return length;
+	}
+
+	std::optional<DecodedInstruction> InstructionDecoder::Decode(std::span<const std::uint8_t> code)
+	{
+		constexpr std::size_t maxLength = 15;
+
+		std::size_t at   = 0;
+		bool operandSize = false;
+		bool addressSize = false;
+		bool rexW        = false;
+
+		for (; at < code.size() && at < maxLength; ++at)
+		{
+			const auto byte = code[at];
+			if (byte == 0x66)
+				operandSize = true;
+			else if (byte == 0x67)
+				addressSize = true;
+			else if (byte != 0xF0 && byte != 0xF2 && byte != 0xF3 && byte != 0x26 && byte != 0x2E && byte != 0x36 && byte != 0x3E && byte != 0x64 && byte != 0x65)
+				break;
+		}
+		// REX only counts right in front of the opcode
+		if (at < code.size() && (code[at] & 0xF0) == 0x40)
+		{
+			rexW = code[at] & 8;
+			at++;
+		}
+		if (at >= code.size())
+			return std::nullopt;
+
+		std::uint8_t flags;
+		std::uint8_t relative = 0;
+		bool branch           = false;
+
+		const auto opcode = code[at++];
+		if (opcode == 0x0F)
+		{
+			if (at >= code.size())
+				return std::nullopt;
+
+			const auto second = code[at++];
+			if (second == 0x38)
+			{
+				at++;
+				flags = Operand::ModRm;
+			}
+			else if (second == 0x3A)
+			{
+				at++;
+				flags = Operand::ModRm | Operand::Imm8;
+			}
+			else
+			{
+				flags = s_TwoByte[second];
+			}
+		}
+		else if (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62)
+		{
+			// VEX and EVEX carry the opcode map in their payload, the opcode and a ModRM always follow
+			const std::size_t payload = opcode == 0xC5 ? 1 : opcode == 0xC4 ? 2 : 3;
+			if (at + payload >= code.size())
+				return std::nullopt;
+
+			const auto map = opcode == 0xC5 ? 1 : code[at] & (opcode == 0xC4 ? 0x1F : 0x03);
+			at += payload;
+
+			const auto vexOpcode = code[at++];
+			switch (map)
+			{
+			case 1:
+				if (vexOpcode == 0x77)
+					flags = Operand::None;
+				else
+					flags = (s_TwoByte[vexOpcode] & Operand::Imm8) ? Operand::ModRm | Operand::Imm8 : Operand::ModRm;
+				break;
+			case 2: flags = Operand::ModRm; break;
+			case 3: flags = Operand::ModRm | Operand::Imm8; break;
+			default: return std::nullopt;
+			}
+		}
+		else
+		{
+			flags = s_OneByte[opcode];
+			if (flags & Operand::Special)
+			{
+				switch (opcode)
+				{
+				case 0xA0:
+				case 0xA1:
+				case 0xA2:
+				case 0xA3: at += addressSize ? 4 : 8; flags = Operand::None; break;
+				case 0xC8: at += 3; flags = Operand::None; break;
+				case 0xF6:
+				case 0xF7:
+				{
+					if (at >= code.size())
+						return std::nullopt;
+
+					const auto test = ((code[at] >> 3) & 7) < 2;
+					flags           = Operand::ModRm | (test ? (opcode == 0xF6 ? Operand::Imm8 : Operand::ImmZ) : Operand::None);
+					break;
+				}
+				default:
+					if (opcode >= 0xB8 && opcode < 0xC0)
+					{
+						at += rexW ? 8 : operandSize ? 2 : 4;
+						flags = Operand::None;
+						break;
+					}
+					// a prefix or REX after the REX position
+					return std::nullopt;
+				}
+			}
+		}
+
+		if (flags & Operand::Invalid)
+			return std::nullopt;
+
+		if (flags & Operand::ModRm)
+		{
+			const auto length = ModRmLength(code, at, relative);
+			if (!length)
+				return std::nullopt;
+			at += *length;
+		}
+		if (flags & Operand::Imm8)
+			at += 1;
+		if (flags & Operand::Imm16)
+			at += 2;
+		if (flags & Operand::ImmZ)
+			at += operandSize ? 2 : 4;
+		if (flags & Operand::Rel8)
+			at += 1;
+		if (flags & Operand::Rel32)
+		{
+			relative = static_cast<std::uint8_t>(at);
+			branch   = true;
+			at += 4;
+		}
+
+		if (at > code.size() || at > maxLength)
+			return std::nullopt;
+		return DecodedInstruction{static_cast<std::uint8_t>(at), relative, branch};
+	}
+}
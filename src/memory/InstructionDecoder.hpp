@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace NewBase
+{
+	/**
+	 * @brief Length of an x86-64 instruction and where its position dependent operand sits, nothing else is decoded.
+	 */
+	struct DecodedInstruction
+	{
+		std::uint8_t m_Length;
+		std::uint8_t m_RelativeOffset; // offset of the rel32 or RIP relative disp32, 0 if the instruction has none
+		bool m_Branch;                  // the relative operand is a rel32 branch target instead of a RIP relative memory operand
+
+		constexpr bool HasRelative() const
+		{
+			return m_RelativeOffset != 0;
+		}
+		/**
+		 * @brief Bytes between the end of the relative operand and the end of the instruction, the immediate that follows it.
+		 */
+		constexpr std::uint8_t RelativeTrailing() const
+		{
+			return m_Length - m_RelativeOffset - 4;
+		}
+	};
+
+	class InstructionDecoder
+	{
+	public:
+		/**
+		 * @brief Decodes the length of the instruction at the start of code, covering the general purpose, x87, SSE, VEX and EVEX encodings.
+		 *
+		 * @return std::nullopt If the bytes are not a valid 64-bit mode instruction or it does not fit into code
+		 */
+		static std::optional<DecodedInstruction> Decode(std::span<const std::uint8_t> code);
+	};
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <future>
+
+namespace NewBase
+{
+	/**
+	 * @brief A pointer that may still be resolved by a background scan.
+	 * Reading it before the scan has finished blocks until it has, reads afterwards are a single atomic load.
+	 */
+	template<typename T = void*>
+	class LazyPointer final
+	{
+	private:
+		std::atomic<T> m_Value;
+		std::shared_future<void> m_Pending;
+
+	public:
+		LazyPointer() :
+		    m_Value(nullptr),
+		    m_Pending()
+		{
+		}
+
+		LazyPointer& operator=(T value)
+		{
+			m_Value.store(value, std::memory_order_release);
+			return *this;
+		}
+
+		/**
+		 * @brief Ties the pointer to the scan that is going to assign it, must happen before the pointer is shared with other threads.
+		 */
+		void Defer(const std::shared_future<void>& pending)
+		{
+			m_Pending = pending;
+		}
+
+		/**
+		 * @brief Whether Get() would return without blocking.
+		 */
+		bool Ready() const
+		{
+			return m_Value.load(std::memory_order_acquire) || !m_Pending.valid() || m_Pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		/**
+		 * @brief Waits for the pending scan if there is one.
+		 *
+		 * @return T nullptr if the scan did not find the pattern
+		 */
+		T Get() const
+		{
+			if (const auto value = m_Value.load(std::memory_order_acquire))
+				return value;
+
+			if (m_Pending.valid())
+				m_Pending.wait();
+			return m_Value.load(std::memory_order_acquire);
+		}
+
+		operator T() const
+		{
+			return Get();
+		}
+	};
+}
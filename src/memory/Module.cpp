@@ -1,26 +1,38 @@
 #include "Module.hpp"
 
-struct CodeViewInfo
-{
-	char CVSignature[4];
-	GUID Guid;
-	DWORD Age;
-	char PdbFilePath[];
-};
+#include "util/Joaat.hpp"
+
+#include <algorithm>
+#include <charconv>
 
 namespace NewBase
 {
 	Module::Module(LDR_DATA_TABLE_ENTRY* dllEntry) :
-	    m_Path(dllEntry->FullDllName.Buffer),
+	    Module(dllEntry->FullDllName.Buffer, reinterpret_cast<std::uintptr_t>(dllEntry->DllBase))
+	{
+	}
+
+	Module::Module(const std::filesystem::path& path, std::uintptr_t base) :
+	    m_Path(path),
 	    m_Name(m_Path.filename().string()),
-	    m_Base(dllEntry->DllBase),
-	    m_Size(0)
+	    m_Base(base),
+	    m_Image(reinterpret_cast<const void*>(base)),
+	    m_Size(m_Image.SizeOfImage()),
+	    m_Sections()
 	{
-		const auto ntHeader = GetNtHeader();
-		if (ntHeader)
+		for (const auto& section : m_Image.Sections())
 		{
-			m_Size = ntHeader->OptionalHeader.SizeOfCode;
+			const auto name = reinterpret_cast<const char*>(section.Name);
+			const auto size = section.Misc.VirtualSize ? section.Misc.VirtualSize : section.SizeOfRawData;
+			if (!size || section.VirtualAddress >= m_Size)
+				continue;
+
+			m_Sections.push_back({std::string(name, strnlen(name, IMAGE_SIZEOF_SHORT_NAME)),
+			    section.VirtualAddress,
+			    static_cast<std::uint32_t>(std::min<std::uintptr_t>(size, m_Size - section.VirtualAddress)),
+			    section.Characteristics});
 		}
+		std::ranges::sort(m_Sections, {}, &ModuleSection::m_Rva);
 	}
 
 	const std::string_view Module::Name() const
@@ -30,50 +42,210 @@ namespace NewBase
 
 	void** Module::GetImport(const std::string_view moduleName, const std::string_view symbolName) const
 	{
-		const auto ntHeader = GetNtHeader();
-		if (!ntHeader)
+		const auto& imports = Imports();
+		const auto library  = imports.m_Libraries.find(Joaat(moduleName));
+		if (library == imports.m_Libraries.end())
 			return nullptr;
 
-		const auto imageDataDirectory = ntHeader->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+		const auto it = library->second.m_Names.find(symbolName);
+		return it != library->second.m_Names.end() ? it->second : nullptr;
+	}
 
-		auto importDescriptor = m_Base.Add(imageDataDirectory.VirtualAddress).As<IMAGE_IMPORT_DESCRIPTOR*>();
-		for (; importDescriptor->Name; importDescriptor++)
-		{
-			if (const auto modName = m_Base.Add(importDescriptor->Name).As<const char*>(); strcmp(modName, moduleName.data()))
-				continue;
+	void** Module::GetImport(const std::string_view moduleName, const std::uint16_t ordinal) const
+	{
+		const auto& imports = Imports();
+		const auto library  = imports.m_Libraries.find(Joaat(moduleName));
+		if (library == imports.m_Libraries.end())
+			return nullptr;
+
+		const auto it = library->second.m_Ordinals.find(ordinal);
+		return it != library->second.m_Ordinals.end() ? it->second : nullptr;
+	}
+
+	const Module::ImportIndex& Module::Imports() const
+	{
+		std::call_once(m_ImportsBuilt, [this] {
+			auto index = std::make_unique<ImportIndex>();
 
-			auto firstThunk = m_Base.Add(importDescriptor->FirstThunk).As<IMAGE_THUNK_DATA*>();
-			auto origThunk  = m_Base.Add(importDescriptor->OriginalFirstThunk).As<IMAGE_THUNK_DATA*>();
-			for (; origThunk->u1.AddressOfData != 0; firstThunk++, origThunk++)
+			for (const auto& descriptor : m_Image.Imports())
 			{
-				if (const auto importData = m_Base.Add(origThunk->u1.AddressOfData).As<IMAGE_IMPORT_BY_NAME*>();
-				    strcmp(importData->Name, symbolName.data()))
+				// without the unbound thunks the names are gone once the loader has filled the IAT
+				const auto thunks = m_Image.Thunks(descriptor.OriginalFirstThunk);
+				if (thunks.empty() || !m_Image.At<IMAGE_THUNK_DATA>(descriptor.FirstThunk, thunks.size()))
 					continue;
-				return reinterpret_cast<void**>(&firstThunk->u1.Function);
+
+				auto& library = index->m_Libraries[Joaat(m_Image.String(descriptor.Name))];
+				for (std::size_t i = 0; i < thunks.size(); i++)
+				{
+					const auto slot = m_Base.Add(descriptor.FirstThunk + i * sizeof(IMAGE_THUNK_DATA)).As<void**>();
+					if (IMAGE_SNAP_BY_ORDINAL64(thunks[i].u1.Ordinal))
+					{
+						library.m_Ordinals.emplace(static_cast<std::uint16_t>(IMAGE_ORDINAL64(thunks[i].u1.Ordinal)), slot);
+						continue;
+					}
+
+					if (thunks[i].u1.AddressOfData >= m_Size)
+						continue;
+
+					const auto name = m_Image.String(static_cast<std::uint32_t>(thunks[i].u1.AddressOfData + offsetof(IMAGE_IMPORT_BY_NAME, Name)));
+					if (!name.empty())
+						library.m_Names.emplace(name, slot);
+				}
 			}
-		}
+
+			m_Imports = std::move(index);
+		});
+		return *m_Imports;
+	}
+
+	const ModuleExport* Module::FindExport(const std::string_view symbolName) const
+	{
+		const auto& exports = Exports();
+		if (const auto it = exports.m_Names.find(symbolName); it != exports.m_Names.end())
+			return &exports.m_Functions[it->second];
 		return nullptr;
 	}
 
+	const ModuleExport* Module::FindExport(const std::uint32_t ordinal) const
+	{
+		const auto& exports = Exports();
+		if (ordinal < exports.m_OrdinalBase || ordinal - exports.m_OrdinalBase >= exports.m_Functions.size())
+			return nullptr;
+
+		const auto& entry = exports.m_Functions[ordinal - exports.m_OrdinalBase];
+		return entry.m_Rva || !entry.m_Forwarder.empty() ? &entry : nullptr;
+	}
+
+	void Module::SetForwarderResolver(ForwarderResolver resolver)
+	{
+		s_ForwarderResolver = resolver;
+	}
+
+	const Module::ExportIndex& Module::Exports() const
+	{
+		std::call_once(m_ExportsBuilt, [this] {
+			auto index = std::make_unique<ExportIndex>();
+			index->m_OrdinalBase = 0;
+
+			const auto exports = m_Image.Exports();
+			if (!exports)
+			{
+				m_Exports = std::move(index);
+				return;
+			}
+
+			const auto& range    = exports->m_Range;
+			index->m_OrdinalBase = exports->m_Directory->Base;
+			index->m_Functions.reserve(exports->m_Functions.size());
+			for (std::uint32_t i = 0; i < exports->m_Functions.size(); i++)
+			{
+				const auto rva = exports->m_Functions[i];
+				if (!rva || rva >= m_Size)
+				{
+					index->m_Functions.push_back({0, index->m_OrdinalBase + i, {}});
+					continue;
+				}
+
+				// an RVA inside the export directory is the "Module.Symbol" string of a forwarder instead of code
+				if (rva >= range.VirtualAddress && rva - range.VirtualAddress < range.Size)
+				{
+					index->m_Functions.push_back({0, index->m_OrdinalBase + i, m_Image.String(rva)});
+					continue;
+				}
+				index->m_Functions.push_back({rva, index->m_OrdinalBase + i, {}});
+			}
+
+			// names are a separate sorted table, AddressOfNameOrdinals maps each one to its slot in the function table
+			index->m_Names.reserve(exports->m_Names.size());
+			for (std::size_t i = 0; i < exports->m_Names.size(); i++)
+			{
+				const auto name = m_Image.String(exports->m_Names[i]);
+				if (name.empty() || exports->m_NameOrdinals[i] >= index->m_Functions.size())
+					continue;
+
+				index->m_Names.emplace(name, exports->m_NameOrdinals[i]);
+			}
+
+			m_Exports = std::move(index);
+		});
+		return *m_Exports;
+	}
+
+	std::uintptr_t Module::ExportAddress(const ModuleExport* entry, int depth) const
+	{
+		if (!entry)
+			return 0;
+		if (entry->m_Forwarder.empty())
+			return Base() + entry->m_Rva;
+
+		const auto separator = entry->m_Forwarder.rfind('.');
+		const auto resolver  = s_ForwarderResolver.load();
+		if (separator == std::string_view::npos || !resolver || depth >= s_MaxForwarderDepth)
+			return 0;
+
+		const auto moduleName = std::string(entry->m_Forwarder.substr(0, separator)) + ".dll";
+		const auto symbol     = entry->m_Forwarder.substr(separator + 1);
+
+		const auto module = resolver(moduleName);
+		if (!module)
+		{
+			LOG(WARNING) << "Export " << entry->m_Forwarder << " forwarded by " << m_Name << " lives in a module that is not loaded.";
+			return 0;
+		}
+
+		if (symbol.starts_with('#'))
+		{
+			std::uint32_t ordinal = 0;
+			if (std::from_chars(symbol.data() + 1, symbol.data() + symbol.size(), ordinal).ec != std::errc{})
+				return 0;
+			return module->ExportAddress(module->FindExport(ordinal), depth + 1);
+		}
+		return module->ExportAddress(module->FindExport(symbol), depth + 1);
+	}
+
 	char* Module::GetPdbFilePath()
 	{
-		auto entry           = GetNtHeader()->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
-		auto debug_directory = m_Base.Add(entry.VirtualAddress).As<IMAGE_DEBUG_DIRECTORY*>();
-		auto codeview        = m_Base.Add(debug_directory->AddressOfRawData).As<CodeViewInfo*>();
-		return codeview->PdbFilePath;
+		const auto codeview = m_Image.CodeView();
+		return codeview ? const_cast<char*>(codeview->PdbFilePath) : nullptr;
 	}
 
-	bool Module::Valid() const
+	ModuleIdentity Module::Identity() const
 	{
-		return m_Size;
+		ModuleIdentity identity{};
+
+		const auto ntHeader = m_Image.NtHeader();
+		if (!ntHeader)
+			return identity;
+
+		identity.m_TimeDateStamp = ntHeader->FileHeader.TimeDateStamp;
+		identity.m_SizeOfImage   = ntHeader->OptionalHeader.SizeOfImage;
+
+		if (const auto codeview = m_Image.CodeView())
+		{
+			memcpy(identity.m_Guid.data(), &codeview->Guid, identity.m_Guid.size());
+			identity.m_Age = codeview->Age;
+		}
+
+		return identity;
 	}
 
-	IMAGE_NT_HEADERS* Module::GetNtHeader() const
+	const ModuleSection* Module::GetSection(const std::string_view name) const
 	{
-		if (!m_Base)
-			return nullptr;
+		for (const auto& section : m_Sections)
+		{
+			if (section.m_Name == name)
+				return &section;
+		}
+		return nullptr;
+	}
+
+	std::span<const RUNTIME_FUNCTION> Module::RuntimeFunctions() const
+	{
+		return m_Image.RuntimeFunctions();
+	}
 
-		const auto offset = m_Base.As<IMAGE_DOS_HEADER*>()->e_lfanew;
-		return m_Base.Add(offset).As<IMAGE_NT_HEADERS*>();
+	bool Module::Valid() const
+	{
+		return m_Size;
 	}
 }
\ No newline at end of file
@@ -1,38 +1,94 @@
 #pragma once
+#include "PEImage.hpp"
 #include "PointerCalculator.hpp"
+#include "SectionFilter.hpp"
 #include "common.hpp"
 
+#include <mutex>
+#include <span>
+#include <unordered_map>
 #include <winternl.h>
 
 namespace NewBase
 {
+	/**
+	 * @brief Uniquely identifies a build of a PE image, two images with an equal identity contain the same code.
+	 */
+	struct ModuleIdentity
+	{
+		std::uint32_t m_TimeDateStamp;
+		std::uint32_t m_SizeOfImage;
+		std::array<std::uint8_t, 16> m_Guid;
+		std::uint32_t m_Age;
+
+		bool operator==(const ModuleIdentity&) const = default;
+	};
+
+	/**
+	 * @brief One function of the export address table.
+	 */
+	struct ModuleExport
+	{
+		std::uint32_t m_Rva;          // zero if forwarded
+		std::uint32_t m_Ordinal;      // biased by the directory base, the way GetProcAddress takes ordinals
+		std::string_view m_Forwarder; // "Module.Symbol" or "Module.#Ordinal" if the function lives in another module
+	};
+
+	class Module;
+
+	/**
+	 * @brief Finds the module a forwarded export points into by its file name.
+	 */
+	using ForwarderResolver = Module* (*)(const std::string_view name);
+
 	class Module
 	{
 	public:
 		Module(LDR_DATA_TABLE_ENTRY* dllEntry);
+		/**
+		 * @brief Wraps an image that is already laid out by section RVAs, like one mapped by hand from a file on disk.
+		 */
+		Module(const std::filesystem::path& path, std::uintptr_t base);
 		~Module() = default;
 
 		const std::string_view Name() const;
+		/**
+		 * @brief Base of the image, Size() and End() cover the whole image including headers.
+		 */
 		inline const std::uintptr_t Base() const;
 		inline const std::uintptr_t Size() const;
 		inline const std::uintptr_t End() const;
 
 		/**
-		 * @brief Parses the EAT of the module for the requested symbolname
+		 * @brief Looks the requested symbolname up in the export index of the module, follows forwarders into other modules
 		 * 
 		 * @param symbolName 
 		 * @return void* Function address of the exported function
 		 */
 		template<typename T = void*>
 		T GetExport(const std::string_view symbolName) const;
+		template<typename T = void*>
+		T GetExport(const std::uint32_t ordinal) const;
+		/**
+		 * @brief Export table entry by name or ordinal, the index is built on the first lookup and never changes afterwards.
+		 * 
+		 * @return const ModuleExport* nullptr if the module exports no such function
+		 */
+		const ModuleExport* FindExport(const std::string_view symbolName) const;
+		const ModuleExport* FindExport(const std::uint32_t ordinal) const;
+		/**
+		 * @brief Sets how every module finds the target of a forwarded export, without one forwarders do not resolve.
+		 */
+		static void SetForwarderResolver(ForwarderResolver resolver);
 		/**
-		 * @brief Gets the address of the import function
+		 * @brief Gets the IAT slot of an import from the import index, built on the first lookup
 		 * 
-		 * @param moduleName The module to get the import from
+		 * @param moduleName The module to get the import from, case insensitive like the loader
 		 * @param symbolName The function name
-		 * @return void** 
+		 * @return void** nullptr if the module does not import the function
 		 */
 		void** GetImport(const std::string_view moduleName, const std::string_view symbolName) const;
+		void** GetImport(const std::string_view moduleName, const std::uint16_t ordinal) const;
 
 		/**
 		* @brief Gets the PDB file path. This should not work with anything that isn't GTA5.exe, use with caution
@@ -41,16 +97,68 @@ namespace NewBase
 		*/
 		char* GetPdbFilePath();
 
+		/**
+		 * @brief Gets the build identity from the PE timestamp, SizeOfImage and the CodeView GUID/Age.
+		 * 
+		 * @return ModuleIdentity, GUID and Age are zeroed if the module has no CodeView record
+		 */
+		ModuleIdentity Identity() const;
+
 		bool Valid() const;
 
+		/**
+		 * @brief Section table of the image, ordered by RVA.
+		 */
+		inline const std::vector<ModuleSection>& Sections() const;
+		const ModuleSection* GetSection(const std::string_view name) const;
+
+		/**
+		 * @brief The exception directory, one entry per function or function fragment sorted by begin address.
+		 */
+		std::span<const RUNTIME_FUNCTION> RuntimeFunctions() const;
+
 	private:
-		IMAGE_NT_HEADERS* GetNtHeader() const;
+		struct ExportIndex
+		{
+			std::uint32_t m_OrdinalBase;
+			std::vector<ModuleExport> m_Functions;                       // by ordinal minus the base, unused slots have neither RVA nor forwarder
+			std::unordered_map<std::string_view, std::uint32_t> m_Names; // name in the image to m_Functions index
+		};
+
+		struct ImportLibrary
+		{
+			std::unordered_map<std::string_view, void**> m_Names;
+			std::unordered_map<std::uint16_t, void**> m_Ordinals;
+		};
+
+		struct ImportIndex
+		{
+			std::unordered_map<std::uint32_t, ImportLibrary> m_Libraries; // by Joaat of the library name
+		};
+
+		const ExportIndex& Exports() const;
+		const ImportIndex& Imports() const;
+		/**
+		 * @brief Address of an export, hops through at most a few forwarders.
+		 * 
+		 * @return std::uintptr_t 0 if entry is nullptr or its forwarder cannot be followed
+		 */
+		std::uintptr_t ExportAddress(const ModuleExport* entry, int depth = 0) const;
 
 	private:
 		const std::filesystem::path m_Path;
 		const std::string m_Name;
 		PointerCalculator m_Base;
+		PEImage m_Image;
 		std::uintptr_t m_Size;
+		std::vector<ModuleSection> m_Sections;
+		mutable std::once_flag m_ExportsBuilt;
+		mutable std::unique_ptr<const ExportIndex> m_Exports;
+		mutable std::once_flag m_ImportsBuilt;
+		mutable std::unique_ptr<const ImportIndex> m_Imports;
+
+		static inline std::atomic<ForwarderResolver> s_ForwarderResolver = nullptr;
+		static constexpr int s_MaxForwarderDepth = 8;
 	};
 
 	inline const std::uintptr_t Module::Base() const
@@ -68,28 +176,28 @@ namespace NewBase
 		return Base() + m_Size;
 	}
 
+	inline const std::vector<ModuleSection>& Module::Sections() const
+	{
+		return m_Sections;
+	}
+
 	template<typename T>
 	inline T Module::GetExport(const std::string_view symbolName) const
 	{
-		const auto ntHeader = GetNtHeader();
-		if (!ntHeader)
-			return nullptr;
-
-		const auto imageDataDirectory = ntHeader->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
-		const auto exportDirectory    = m_Base.Add(imageDataDirectory.VirtualAddress).As<IMAGE_EXPORT_DIRECTORY*>();
-		const auto namesOffsets       = m_Base.Add(exportDirectory->AddressOfNames).As<DWORD*>();
-		const auto funcOffsets        = m_Base.Add(exportDirectory->AddressOfFunctions).As<DWORD*>();
+		if (const auto address = ExportAddress(FindExport(symbolName)))
+			return PointerCalculator(address).As<T>();
 
-		for (std::size_t i = 0; i < exportDirectory->NumberOfFunctions; i++)
-		{
-			const auto functionName = m_Base.Add(namesOffsets[i]).As<const char*>();
-			if (strcmp(functionName, symbolName.data()))
-				continue;
+		LOG(FATAL) << "Cannot find export: " << symbolName;
+		return {};
+	}
 
-			return m_Base.Add(funcOffsets[i]).As<T>();
-		}
+	template<typename T>
+	inline T Module::GetExport(const std::uint32_t ordinal) const
+	{
+		if (const auto address = ExportAddress(FindExport(ordinal)))
+			return PointerCalculator(address).As<T>();
 
-		LOG(FATAL) << "Cannot find export: " << symbolName;
-		return nullptr;
+		LOG(FATAL) << "Cannot find export: #" << ordinal;
+		return {};
 	}
 }
\ No newline at end of file
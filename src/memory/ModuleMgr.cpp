@@ -11,39 +11,114 @@ namespace NewBase
 
 	Module* ModuleMgr::GetImpl(joaat_t hash)
 	{
-		if (const auto& it = m_CachedModules.find(hash); it != m_CachedModules.end())
+		// a module loaded, unloaded or moved since the last snapshot, a hit in it could point at a dead base
+		if (m_Stale.load(std::memory_order_acquire))
+			RefreshImpl();
+
+		if (const auto snapshot = m_Snapshot.load(std::memory_order_acquire))
 		{
-			return it->second.get();
+			if (const auto it = snapshot->m_Modules.find(hash); it != snapshot->m_Modules.end())
+				return it->second;
 		}
 		return nullptr;
 	}
 
-	bool ModuleMgr::InitImpl()
+	const AddressMap& ModuleMgr::AddressesImpl() const
+	{
+		static const AddressMap empty;
+
+		const auto snapshot = m_Snapshot.load(std::memory_order_acquire);
+		return snapshot ? snapshot->m_Addresses : empty;
+	}
+
+	bool ModuleMgr::InitImpl(std::unique_ptr<IModuleProvider> provider)
+	{
+		{
+			std::lock_guard lock(m_RefreshMutex);
+			if (m_Provider)
+				return m_Snapshot.load() != nullptr;
+
+			m_Provider = std::move(provider);
+			if (!m_Provider)
+				return false;
+
+			// forwarded exports land in other loaded modules, which only the manager knows about
+			Module::SetForwarderResolver([](const std::string_view name) {
+				return Get(name);
+			});
+
+			m_Provider->Watch([this] {
+				m_Stale.store(true, std::memory_order_release);
+			});
+		}
+		return RefreshImpl();
+	}
+
+	bool ModuleMgr::RefreshImpl()
 	{
-		const auto peb = reinterpret_cast<PPEB>(NtCurrentTeb()->ProcessEnvironmentBlock);
-		if (!peb)
+		std::lock_guard lock(m_RefreshMutex);
+		if (!m_Provider)
 			return false;
 
-		const auto ldrData = peb->Ldr;
-		if (!ldrData)
+		// cleared before the list is read so a module loading meanwhile marks the new snapshot stale again
+		m_Stale.store(false, std::memory_order_release);
+
+		const auto modules = m_Provider->Modules();
+		if (modules.empty())
+		{
+			// the list could not be read, the next lookup tries again
+			m_Stale.store(true, std::memory_order_release);
 			return false;
+		}
+
+		const auto previous = m_Snapshot.load(std::memory_order_acquire);
+		auto snapshot       = std::make_unique<Snapshot>();
+		snapshot->m_Modules.reserve(modules.size());
 
-		const auto moduleList = &ldrData->InMemoryOrderModuleList;
-		auto moduleEntry      = moduleList->Flink;
-		for (; moduleList != moduleEntry; moduleEntry = moduleEntry->Flink)
+		// every name is hashed in one batch, the loader list easily holds a couple hundred modules
+		std::vector<std::string> names;
+		names.reserve(modules.size());
+		for (const auto& loaded : modules)
+			names.push_back(loaded.m_Path.filename().string());
+		const std::vector<std::string_view> views(names.begin(), names.end());
+		std::vector<joaat_t> hashes(views.size());
+		Joaat(views, hashes);
+
+		std::size_t added = 0;
+		for (std::size_t i = 0; i < modules.size(); ++i)
 		{
-			const auto tableEntry = CONTAINING_RECORD(moduleEntry, LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
-			if (!tableEntry)
+			const auto& loaded = modules[i];
+			const auto hash    = hashes[i];
+			if (snapshot->m_Modules.contains(hash))
 				continue;
 
-			if (tableEntry->FullDllName.Buffer)
+			// modules still mapped at the same base are the same image, keep the parsed ones
+			if (previous)
 			{
-				auto module = std::make_unique<Module>(tableEntry);
-
-				m_CachedModules.emplace(Joaat(module->Name()), std::move(module));
+				if (const auto it = previous->m_Modules.find(hash); it != previous->m_Modules.end() && it->second->Base() == loaded.m_Base)
+				{
+					snapshot->m_Modules.emplace(hash, it->second);
+					continue;
+				}
 			}
+
+			auto module = std::make_unique<Module>(loaded.m_Path, loaded.m_Base);
+			snapshot->m_Modules.emplace(hash, module.get());
+			m_Modules.push_back(std::move(module));
+			added++;
 		}
 
+		if (previous && !added && snapshot->m_Modules.size() == previous->m_Modules.size())
+			return true;
+
+		std::vector<const Module*> ranges;
+		ranges.reserve(snapshot->m_Modules.size());
+		for (const auto& [hash, module] : snapshot->m_Modules)
+			ranges.push_back(module);
+		snapshot->m_Addresses = AddressMap(ranges);
+
+		m_Snapshot.store(snapshot.get(), std::memory_order_release);
+		m_Snapshots.push_back(std::move(snapshot));
 		return true;
 	}
-}
\ No newline at end of file
+}
@@ -1,7 +1,11 @@
 #pragma once
+#include "AddressMap.hpp"
 #include "Module.hpp"
+#include "ModuleProvider.hpp"
 #include "common.hpp"
 
+#include <mutex>
+
 namespace NewBase
 {
 	using joaat_t = std::uint32_t;
@@ -17,6 +21,11 @@ namespace NewBase
 		ModuleMgr& operator=(ModuleMgr&&) noexcept = delete;
 
 
+		/**
+		 * @brief Looks the module up in the current snapshot without taking a lock, refreshes first if the provider reported a change.
+		 * 
+		 * @return Module* Stays valid for the lifetime of the process, even after the module is unloaded
+		 */
 		static Module* Get(const std::string_view name)
 		{
 			return GetInstance().GetImpl(name);
@@ -28,32 +37,52 @@ namespace NewBase
 		}
 
 		/**
-		 * @brief Loads the modules from PEB and caches them.
+		 * @brief Which module and section own an address, as of the last published snapshot.
 		 * 
-		 * @return true If the peb is found and modules have been cached.
-		 * @return false If the peb or peb->Ldr pointer were invalid. 
+		 * @return const AddressMap& Immutable and never freed, safe to keep and query from any thread
 		 */
-		static bool Init()
+		static const AddressMap& Addresses()
 		{
-			if (GetInstance().m_CachedModules.empty())
-				return GetInstance().InitImpl();
+			return GetInstance().AddressesImpl();
+		}
 
-			return true;
+		/**
+		 * @brief Takes the first snapshot of the modules the provider lists and subscribes to its change notifications.
+		 * 
+		 * @return true If the provider listed any modules.
+		 * @return false If the provider could not read the module list.
+		 */
+		static bool Init(std::unique_ptr<IModuleProvider> provider)
+		{
+			return GetInstance().InitImpl(std::move(provider));
 		};
 
 		/**
-		 * @brief Refresh loaded modules from the PEB and caches them.
+		 * @brief Publishes a new snapshot if modules were loaded or unloaded since the last one, only new modules are parsed.
 		 * 
-		 * @return true If the peb is found and modules have been cached.
-		 * @return false If the peb or peb->Ldr pointer were invalid. 
+		 * @return true If the provider listed any modules.
+		 * @return false If the provider could not read the module list.
 		 */
 		static bool Refresh()
 		{
-			return GetInstance().InitImpl();
+			return GetInstance().RefreshImpl();
 		}
 
 	private:
-		std::unordered_map<std::uint32_t, std::unique_ptr<Module>> m_CachedModules;
+		struct Snapshot
+		{
+			std::unordered_map<joaat_t, Module*> m_Modules;
+			AddressMap m_Addresses;
+		};
+
+		std::unique_ptr<IModuleProvider> m_Provider;
+		std::atomic<const Snapshot*> m_Snapshot = nullptr;
+		std::atomic<bool> m_Stale               = false;
+		std::mutex m_RefreshMutex;
+		// readers never announce when they are done with a snapshot or a module, so neither is ever freed;
+		// snapshots are only published when something changed and a lookup or Refresh asks for it
+		std::vector<std::unique_ptr<Module>> m_Modules;
+		std::vector<std::unique_ptr<const Snapshot>> m_Snapshots;
 
 		static ModuleMgr& GetInstance()
 		{
@@ -61,8 +90,10 @@ namespace NewBase
 			return i;
 		}
 
-		bool InitImpl();
+		bool InitImpl(std::unique_ptr<IModuleProvider> provider);
+		bool RefreshImpl();
 		Module* GetImpl(const std::string_view name);
 		Module* GetImpl(joaat_t hash);
+		const AddressMap& AddressesImpl() const;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace NewBase
+{
+	struct LoadedModule
+	{
+		std::filesystem::path m_Path;
+		std::uintptr_t m_Base;
+	};
+
+	/**
+	 * @brief Where ModuleMgr learns which modules are loaded, the process loader in the game and a fixed list anywhere else.
+	 */
+	class IModuleProvider
+	{
+	public:
+		virtual ~IModuleProvider() = default;
+
+		/**
+		 * @brief Every module loaded right now, in load order.
+		 *
+		 * @return std::vector<LoadedModule> Empty if the list cannot be read
+		 */
+		virtual std::vector<LoadedModule> Modules() const = 0;
+
+		/**
+		 * @brief Calls onChange whenever a module is loaded or unloaded, possibly from a thread holding the loader lock.
+		 *
+		 * @return false If the provider cannot tell, changes are only picked up by an explicit refresh then
+		 */
+		virtual bool Watch([[maybe_unused]] std::function<void()> onChange)
+		{
+			return false;
+		}
+	};
+}
@@ -0,0 +1,192 @@
+#include "MultiScanKernel.hpp"
+
+#include <algorithm>
+
+namespace NewBase
+{
+	MultiScanKernel::MultiScanKernel(std::vector<ScanSignature> signatures) :
+	    m_Signatures(std::move(signatures)),
+	    m_Filter(0x10000 / 64),
+	    m_Buckets(0x10000 + 1),
+	    m_MaxOffset(0),
+	    m_MaxLength(0)
+	{
+		std::vector<std::pair<std::uint16_t, Candidate>> entries;
+		for (std::size_t i = 0; i < m_Signatures.size(); ++i)
+		{
+			const auto& signature = m_Signatures[i];
+			const auto best       = signature.m_Pair;
+
+			// signatures without two adjacent fixed bytes are rare enough to get their own pass
+			if (best >= signature.Size())
+			{
+				m_MaxLength = std::max(m_MaxLength, signature.Size());
+				m_Unindexed.push_back(i);
+				continue;
+			}
+
+			const auto key = Key(signature.m_Values.data() + best);
+			m_MaxOffset    = std::max(m_MaxOffset, best);
+			m_MaxLength    = std::max(m_MaxLength, signature.Size());
+			m_Filter[key >> 6] |= 1ull << (key & 63);
+			entries.push_back({key, {static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(best)}});
+		}
+
+		for (const auto& [key, candidate] : entries)
+			m_Buckets[key + 1]++;
+		for (std::size_t key = 0; key < 0x10000; ++key)
+			m_Buckets[key + 1] += m_Buckets[key];
+
+		m_Candidates.resize(entries.size());
+		auto fill = m_Buckets;
+		for (const auto& [key, candidate] : entries)
+			m_Candidates[fill[key]++] = candidate;
+	}
+
+	void MultiScanKernel::FindFirst(const std::uint8_t* begin, const std::uint8_t* end, std::span<const std::uint8_t*> results) const
+	{
+		FindFirst(begin, end, end, results);
+	}
+
+	void MultiScanKernel::FindFirst(const std::uint8_t* begin, const std::uint8_t* end, const std::uint8_t* limit, std::span<const std::uint8_t*> results) const
+	{
+		const auto first = reinterpret_cast<std::uintptr_t>(begin);
+		const auto stop  = reinterpret_cast<std::uintptr_t>(end);
+		const auto bound = reinterpret_cast<std::uintptr_t>(limit);
+		if (first >= stop || bound <= first)
+			return;
+
+		for (const auto index : m_Unindexed)
+		{
+			if (results[index])
+				continue;
+
+			const auto scanEnd = std::min(bound, stop + m_Signatures[index].Size() - 1);
+			results[index]     = ScanKernel::Find(begin, reinterpret_cast<const std::uint8_t*>(scanEnd), m_Signatures[index]);
+		}
+
+		std::size_t remaining = 0;
+		std::size_t last      = 0;
+		for (const auto& candidate : m_Candidates)
+		{
+			if (results[candidate.m_Index])
+				continue;
+
+			remaining++;
+			last = candidate.m_Index;
+		}
+
+		if (!remaining)
+			return;
+
+		// the dedicated kernel beats the table as soon as only one signature is left
+		if (remaining == 1)
+		{
+			const auto scanEnd = std::min(bound, stop + m_Signatures[last].Size() - 1);
+			results[last]      = ScanKernel::Find(begin, reinterpret_cast<const std::uint8_t*>(scanEnd), m_Signatures[last]);
+			return;
+		}
+
+		// a key at i belongs to a match starting at i - offset, keys past end can still complete a match starting before it
+		const auto keyEnd = reinterpret_cast<const std::uint8_t*>(std::min(stop + m_MaxOffset, bound - 1));
+		const auto filter = m_Filter.data();
+		for (auto i = begin; i < keyEnd; ++i)
+		{
+			const auto key = Key(i);
+			if (!(filter[key >> 6] & 1ull << (key & 63)))
+				continue;
+
+			for (auto c = m_Buckets[key]; c < m_Buckets[key + 1]; ++c)
+			{
+				const auto& candidate = m_Candidates[c];
+				if (results[candidate.m_Index])
+					continue;
+
+				const auto& signature = m_Signatures[candidate.m_Index];
+				const auto start      = reinterpret_cast<std::uintptr_t>(i) - candidate.m_Offset;
+				if (start < first || start >= stop || bound - start < signature.Size())
+					continue;
+
+				if (!ScanKernel::Matches(reinterpret_cast<const std::uint8_t*>(start), signature))
+					continue;
+
+				results[candidate.m_Index] = reinterpret_cast<const std::uint8_t*>(start);
+				if (!--remaining)
+					return;
+			}
+		}
+	}
+
+	void MultiScanKernel::FindAll(const std::uint8_t* begin, const std::uint8_t* end, const std::uint8_t* limit, const std::vector<bool>& skip, const MatchFunc& func) const
+	{
+		const auto first = reinterpret_cast<std::uintptr_t>(begin);
+		const auto stop  = reinterpret_cast<std::uintptr_t>(end);
+		const auto bound = reinterpret_cast<std::uintptr_t>(limit);
+		if (first >= stop || bound <= first)
+			return;
+
+		for (const auto index : m_Unindexed)
+		{
+			if (!skip[index])
+				FindEach(index, begin, end, limit, func);
+		}
+
+		std::vector<std::size_t> remaining;
+		for (const auto& candidate : m_Candidates)
+		{
+			if (!skip[candidate.m_Index])
+				remaining.push_back(candidate.m_Index);
+		}
+
+		if (remaining.empty())
+			return;
+
+		// nothing ever drops out of the set here, so a few dedicated passes stay cheaper than the table for longer
+		if (remaining.size() <= s_SeparatePasses)
+		{
+			for (const auto index : remaining)
+				FindEach(index, begin, end, limit, func);
+			return;
+		}
+
+		// every match start maps to exactly one key position, so nothing is reported twice
+		const auto keyEnd = reinterpret_cast<const std::uint8_t*>(std::min(stop + m_MaxOffset, bound - 1));
+		const auto filter = m_Filter.data();
+		for (auto i = begin; i < keyEnd; ++i)
+		{
+			const auto key = Key(i);
+			if (!(filter[key >> 6] & 1ull << (key & 63)))
+				continue;
+
+			for (auto c = m_Buckets[key]; c < m_Buckets[key + 1]; ++c)
+			{
+				const auto& candidate = m_Candidates[c];
+				if (skip[candidate.m_Index])
+					continue;
+
+				const auto& signature = m_Signatures[candidate.m_Index];
+				const auto start      = reinterpret_cast<std::uintptr_t>(i) - candidate.m_Offset;
+				if (start < first || start >= stop || bound - start < signature.Size())
+					continue;
+
+				if (ScanKernel::Matches(reinterpret_cast<const std::uint8_t*>(start), signature))
+					func(candidate.m_Index, reinterpret_cast<const std::uint8_t*>(start));
+			}
+		}
+	}
+
+	void MultiScanKernel::FindEach(std::size_t index, const std::uint8_t* begin, const std::uint8_t* end, const std::uint8_t* limit, const MatchFunc& func) const
+	{
+		const auto& signature = m_Signatures[index];
+		const auto scanEnd    = std::min(limit, end + signature.Size() - 1);
+		for (auto i = begin; i < end;)
+		{
+			const auto match = ScanKernel::Find(i, scanEnd, signature);
+			if (!match || match >= end)
+				return;
+
+			func(index, match);
+			i = match + 1;
+		}
+	}
+}
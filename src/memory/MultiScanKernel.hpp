@@ -0,0 +1,79 @@
+#pragma once
+#include "ScanKernel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace NewBase
+{
+	/**
+	 * @brief Finds any number of signatures in a single pass over memory.
+	 * Every signature is indexed by its rarest pair of adjacent fixed bytes, a 64K bit filter over those pairs
+	 * decides which positions are worth verifying so the cost per byte does not grow with the signature count.
+	 */
+	class MultiScanKernel
+	{
+	public:
+		using MatchFunc = std::function<void(std::size_t index, const std::uint8_t* match)>;
+
+	private:
+		struct Candidate
+		{
+			std::uint32_t m_Index;
+			std::uint32_t m_Offset;
+		};
+
+		std::vector<ScanSignature> m_Signatures;
+		std::vector<std::uint64_t> m_Filter;
+		std::vector<std::uint32_t> m_Buckets;
+		std::vector<Candidate> m_Candidates;
+		std::vector<std::size_t> m_Unindexed;
+		std::size_t m_MaxOffset;
+		std::size_t m_MaxLength;
+
+		static constexpr std::size_t s_SeparatePasses = 4;
+
+	public:
+		explicit MultiScanKernel(std::vector<ScanSignature> signatures);
+
+		std::size_t Count() const
+		{
+			return m_Signatures.size();
+		}
+
+		/**
+		 * @brief Length of the longest signature, neighbouring ranges have to overlap by this minus one byte.
+		 */
+		std::size_t MaxLength() const
+		{
+			return m_MaxLength;
+		}
+
+		/**
+		 * @brief Finds the first match of every signature inside [begin, end) in one pass.
+		 *
+		 * @param results One entry per signature, entries which are not nullptr are treated as already found and skipped.
+		 */
+		void FindFirst(const std::uint8_t* begin, const std::uint8_t* end, std::span<const std::uint8_t*> results) const;
+		/**
+		 * @brief Finds the first match of every signature that starts inside [begin, end) without reading at or past limit.
+		 */
+		void FindFirst(const std::uint8_t* begin, const std::uint8_t* end, const std::uint8_t* limit, std::span<const std::uint8_t*> results) const;
+		/**
+		 * @brief Reports every match that starts inside [begin, end) without reading at or past limit.
+		 * Matches of one signature are reported in ascending order, signatures with a set skip entry are ignored.
+		 */
+		void FindAll(const std::uint8_t* begin, const std::uint8_t* end, const std::uint8_t* limit, const std::vector<bool>& skip, const MatchFunc& func) const;
+
+	private:
+		void FindEach(std::size_t index, const std::uint8_t* begin, const std::uint8_t* end, const std::uint8_t* limit, const MatchFunc& func) const;
+
+		static constexpr std::uint16_t Key(const std::uint8_t* data)
+		{
+			return static_cast<std::uint16_t>(data[0] | data[1] << 8);
+		}
+	};
+}
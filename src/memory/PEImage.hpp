@@ -0,0 +1,347 @@
+#pragma once
+#include <Windows.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace NewBase
+{
+	struct CodeViewInfo
+	{
+		char CVSignature[4];
+		GUID Guid;
+		DWORD Age;
+		char PdbFilePath[];
+	};
+
+	/**
+	 * @brief Read only view of a PE32+ image, either laid out by section RVAs like a loaded module or as the file is on disk.
+	 *
+	 * Nothing is copied. The headers are validated once on construction and every accessor checks what it hands out
+	 * against the bounds of the view, a truncated or malformed image gives empty results instead of reads past its end.
+	 * Only the portable PE structures are used, so the view works the same in the loader and in the host tools.
+	 */
+	class PEImage
+	{
+	public:
+		enum class Layout
+		{
+			Mapped, // every section at its RVA, like the loader or MappedImage lays an image out
+			File    // sections at their raw data offsets, RVAs are translated through the section table
+		};
+
+		struct ExportDirectory
+		{
+			const IMAGE_EXPORT_DIRECTORY* m_Directory;
+			std::span<const DWORD> m_Functions;
+			std::span<const DWORD> m_Names;
+			std::span<const WORD> m_NameOrdinals; // AddressOfFunctions index of every name
+			IMAGE_DATA_DIRECTORY m_Range;         // function RVAs inside this range are forwarder strings
+		};
+
+	private:
+		std::span<const std::uint8_t> m_Data;
+		Layout m_Layout;
+		const IMAGE_NT_HEADERS* m_NtHeader;
+		std::span<const IMAGE_SECTION_HEADER> m_Sections;
+
+	public:
+		PEImage() :
+		    m_Data(),
+		    m_Layout(Layout::Mapped),
+		    m_NtHeader(nullptr),
+		    m_Sections()
+		{
+		}
+
+		PEImage(std::span<const std::uint8_t> data, Layout layout) :
+		    PEImage()
+		{
+			Init(data, layout);
+		}
+
+		/**
+		 * @brief View of an image the loader mapped, its extent is taken from SizeOfImage.
+		 */
+		explicit PEImage(const void* base) :
+		    PEImage()
+		{
+			if (!base)
+				return;
+
+			const auto image = static_cast<const std::uint8_t*>(base);
+			const auto dos   = reinterpret_cast<const IMAGE_DOS_HEADER*>(image);
+			if (dos->e_magic != IMAGE_DOS_SIGNATURE || dos->e_lfanew < 0)
+				return;
+
+			const auto nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(image + dos->e_lfanew);
+			Init({image, nt->OptionalHeader.SizeOfImage}, Layout::Mapped);
+		}
+
+		bool Valid() const
+		{
+			return m_NtHeader;
+		}
+		Layout GetLayout() const
+		{
+			return m_Layout;
+		}
+		std::span<const std::uint8_t> Data() const
+		{
+			return m_Data;
+		}
+		const IMAGE_NT_HEADERS* NtHeader() const
+		{
+			return m_NtHeader;
+		}
+		std::uint32_t SizeOfImage() const
+		{
+			return m_NtHeader ? m_NtHeader->OptionalHeader.SizeOfImage : 0;
+		}
+		/**
+		 * @brief Section headers as they are in the image, not sorted.
+		 */
+		std::span<const IMAGE_SECTION_HEADER> Sections() const
+		{
+			return m_Sections;
+		}
+
+		/**
+		 * @brief The bytes of a section the view holds, on disk that is its raw data without the zero filled tail.
+		 */
+		std::span<const std::uint8_t> SectionData(const IMAGE_SECTION_HEADER& section) const
+		{
+			const std::size_t offset = m_Layout == Layout::Mapped ? section.VirtualAddress : section.PointerToRawData;
+			if (!m_NtHeader || offset >= m_Data.size())
+				return {};
+
+			const auto size = m_Layout == Layout::Mapped ? (section.Misc.VirtualSize ? section.Misc.VirtualSize : section.SizeOfRawData) : RawSize(section);
+			return m_Data.subspan(offset, std::min<std::size_t>(size, m_Data.size() - offset));
+		}
+
+		/**
+		 * @brief Where an RVA is in the view, raw data on disk has no offset for the zero filled tail of a section.
+		 */
+		std::optional<std::size_t> RvaToOffset(std::uint32_t rva) const
+		{
+			const auto bytes = Bytes(rva);
+			if (bytes.empty())
+				return std::nullopt;
+			return static_cast<std::size_t>(bytes.data() - m_Data.data());
+		}
+
+		std::optional<std::uint32_t> OffsetToRva(std::size_t offset) const
+		{
+			if (!m_NtHeader || offset >= m_Data.size())
+				return std::nullopt;
+			if (m_Layout == Layout::Mapped || offset < m_NtHeader->OptionalHeader.SizeOfHeaders)
+				return static_cast<std::uint32_t>(offset);
+
+			for (const auto& section : m_Sections)
+			{
+				if (offset >= section.PointerToRawData && offset - section.PointerToRawData < RawSize(section))
+					return static_cast<std::uint32_t>(section.VirtualAddress + (offset - section.PointerToRawData));
+			}
+			return std::nullopt;
+		}
+
+		/**
+		 * @brief count contiguous objects at an RVA.
+		 *
+		 * @return const T* nullptr unless all of them are inside the view
+		 */
+		template<typename T>
+		const T* At(std::uint32_t rva, std::size_t count = 1) const
+		{
+			const auto bytes = Bytes(rva);
+			if (bytes.empty() || count > bytes.size() / sizeof(T))
+				return nullptr;
+			return reinterpret_cast<const T*>(bytes.data());
+		}
+
+		template<typename T>
+		std::span<const T> Array(std::uint32_t rva, std::size_t count) const
+		{
+			const auto first = At<T>(rva, count);
+			return first ? std::span<const T>(first, count) : std::span<const T>();
+		}
+
+		/**
+		 * @brief Zero terminated string at an RVA, cut off where the view ends.
+		 */
+		std::string_view String(std::uint32_t rva) const
+		{
+			const auto bytes = Bytes(rva);
+			const auto chars = reinterpret_cast<const char*>(bytes.data());
+			return {chars, strnlen(chars, bytes.size())};
+		}
+
+		IMAGE_DATA_DIRECTORY Directory(std::size_t index) const
+		{
+			if (!m_NtHeader || index >= std::min<std::size_t>(m_NtHeader->OptionalHeader.NumberOfRvaAndSizes, IMAGE_NUMBEROF_DIRECTORY_ENTRIES))
+				return {};
+			return m_NtHeader->OptionalHeader.DataDirectory[index];
+		}
+
+		/**
+		 * @brief A data directory read as an array of T, entries that do not fit the view are left out.
+		 */
+		template<typename T>
+		std::span<const T> DirectoryEntries(std::size_t index) const
+		{
+			const auto directory = Directory(index);
+			if (!directory.VirtualAddress)
+				return {};
+
+			const auto count = std::min<std::size_t>(directory.Size / sizeof(T), Bytes(directory.VirtualAddress).size() / sizeof(T));
+			return Array<T>(directory.VirtualAddress, count);
+		}
+
+		std::optional<ExportDirectory> Exports() const
+		{
+			const auto range     = Directory(IMAGE_DIRECTORY_ENTRY_EXPORT);
+			const auto directory = range.VirtualAddress ? At<IMAGE_EXPORT_DIRECTORY>(range.VirtualAddress) : nullptr;
+			if (!directory)
+				return std::nullopt;
+
+			ExportDirectory exports{directory,
+			    Array<DWORD>(directory->AddressOfFunctions, directory->NumberOfFunctions),
+			    Array<DWORD>(directory->AddressOfNames, directory->NumberOfNames),
+			    Array<WORD>(directory->AddressOfNameOrdinals, directory->NumberOfNames),
+			    range};
+			if (exports.m_Functions.size() != directory->NumberOfFunctions || exports.m_Names.size() != directory->NumberOfNames
+			    || exports.m_NameOrdinals.size() != directory->NumberOfNames)
+				return std::nullopt;
+			return exports;
+		}
+
+		/**
+		 * @brief Import descriptors up to the terminating empty one.
+		 */
+		std::span<const IMAGE_IMPORT_DESCRIPTOR> Imports() const
+		{
+			const auto directory = Directory(IMAGE_DIRECTORY_ENTRY_IMPORT);
+			if (!directory.VirtualAddress)
+				return {};
+
+			return Terminated<IMAGE_IMPORT_DESCRIPTOR>(directory.VirtualAddress, [](const IMAGE_IMPORT_DESCRIPTOR& descriptor) {
+				return !descriptor.Name;
+			});
+		}
+
+		/**
+		 * @brief Thunk array of an import descriptor up to its terminating zero.
+		 */
+		std::span<const IMAGE_THUNK_DATA> Thunks(std::uint32_t rva) const
+		{
+			if (!rva)
+				return {};
+
+			return Terminated<IMAGE_THUNK_DATA>(rva, [](const IMAGE_THUNK_DATA& thunk) {
+				return !thunk.u1.AddressOfData;
+			});
+		}
+
+		std::span<const IMAGE_DEBUG_DIRECTORY> DebugDirectory() const
+		{
+			return DirectoryEntries<IMAGE_DEBUG_DIRECTORY>(IMAGE_DIRECTORY_ENTRY_DEBUG);
+		}
+
+		/**
+		 * @brief The RSDS CodeView record naming the PDB of this build, its path is zero terminated within the record.
+		 *
+		 * @return const CodeViewInfo* nullptr if the image has none
+		 */
+		const CodeViewInfo* CodeView() const
+		{
+			for (const auto& debug : DebugDirectory())
+			{
+				if (debug.Type != IMAGE_DEBUG_TYPE_CODEVIEW || !debug.AddressOfRawData || debug.SizeOfData < sizeof(CodeViewInfo))
+					continue;
+
+				const auto record   = Array<char>(debug.AddressOfRawData, debug.SizeOfData);
+				const auto codeview = reinterpret_cast<const CodeViewInfo*>(record.data());
+				if (!record.empty() && !std::memcmp(codeview->CVSignature, "RSDS", 4)
+				    && std::memchr(codeview->PdbFilePath, 0, record.size() - sizeof(CodeViewInfo)))
+					return codeview;
+			}
+			return nullptr;
+		}
+
+		/**
+		 * @brief The exception directory, one entry per function or function fragment sorted by begin address.
+		 */
+		std::span<const RUNTIME_FUNCTION> RuntimeFunctions() const
+		{
+			return DirectoryEntries<RUNTIME_FUNCTION>(IMAGE_DIRECTORY_ENTRY_EXCEPTION);
+		}
+
+	private:
+		void Init(std::span<const std::uint8_t> data, Layout layout)
+		{
+			if (data.size() < sizeof(IMAGE_DOS_HEADER))
+				return;
+
+			const auto dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(data.data());
+			if (dos->e_magic != IMAGE_DOS_SIGNATURE || dos->e_lfanew < 0 || data.size() < sizeof(IMAGE_NT_HEADERS) || static_cast<std::size_t>(dos->e_lfanew) > data.size() - sizeof(IMAGE_NT_HEADERS))
+				return;
+
+			const auto nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(data.data() + dos->e_lfanew);
+			if (nt->Signature != IMAGE_NT_SIGNATURE || nt->OptionalHeader.Magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC)
+				return;
+
+			const auto sections = reinterpret_cast<const std::uint8_t*>(IMAGE_FIRST_SECTION(nt));
+			if (sections + nt->FileHeader.NumberOfSections * sizeof(IMAGE_SECTION_HEADER) > data.data() + data.size())
+				return;
+
+			m_Data     = data;
+			m_Layout   = layout;
+			m_NtHeader = nt;
+			m_Sections = {reinterpret_cast<const IMAGE_SECTION_HEADER*>(sections), nt->FileHeader.NumberOfSections};
+		}
+
+		static std::size_t RawSize(const IMAGE_SECTION_HEADER& section)
+		{
+			// raw data is file aligned and may run past the virtual size
+			return section.Misc.VirtualSize ? std::min<std::size_t>(section.SizeOfRawData, section.Misc.VirtualSize) : section.SizeOfRawData;
+		}
+
+		/**
+		 * @brief Bytes from an RVA to the end of the region that contains it, empty if the RVA is not backed by the view.
+		 */
+		std::span<const std::uint8_t> Bytes(std::uint32_t rva) const
+		{
+			if (!m_NtHeader)
+				return {};
+
+			if (m_Layout == Layout::Mapped)
+				return rva < m_Data.size() ? m_Data.subspan(rva) : std::span<const std::uint8_t>();
+
+			if (rva < m_NtHeader->OptionalHeader.SizeOfHeaders)
+				return m_Data.subspan(0, std::min<std::size_t>(m_NtHeader->OptionalHeader.SizeOfHeaders, m_Data.size())).subspan(std::min<std::size_t>(rva, m_Data.size()));
+
+			for (const auto& section : m_Sections)
+			{
+				if (rva < section.VirtualAddress || rva - section.VirtualAddress >= RawSize(section))
+					continue;
+
+				const auto raw = SectionData(section);
+				return raw.subspan(std::min<std::size_t>(rva - section.VirtualAddress, raw.size()));
+			}
+			return {};
+		}
+
+		template<typename T, typename F>
+		std::span<const T> Terminated(std::uint32_t rva, F&& terminator) const
+		{
+			const auto bytes   = Bytes(rva);
+			const auto entries = std::span<const T>(reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T));
+
+			const auto end = std::ranges::find_if(entries, terminator);
+			return entries.first(end - entries.begin());
+		}
+	};
+}
@@ -1,6 +1,12 @@
 #pragma once
+#include "ScanKernel.hpp"
+#include "SectionFilter.hpp"
 #include "util/StrToHex.hpp"
 
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <ostream>
 #include <string_view>
 
 namespace NewBase
@@ -52,42 +58,82 @@ namespace NewBase
 		}
 	};
 
-	class IPattern
+	/**
+	 * @brief Everything the scanner needs to know about a signature, computed entirely at compile time.
+	 * Lives in read-only data next to the code that uses it, one instance per distinct signature string.
+	 */
+	template<Signature S>
+	struct SignatureLayout
 	{
-	public:
-		constexpr IPattern() = default;
-		virtual ~IPattern()  = default;
+		std::array<std::uint8_t, S.ByteLength()> m_Values{};
+		std::array<std::uint8_t, S.ByteLength()> m_Masks{};
+		std::array<std::uint8_t, 256> m_SkipTable{};
+		std::size_t m_Anchor{};
+		std::size_t m_SecondAnchor{};
+		std::size_t m_Pair{};
+		bool m_HasAnchor{};
 
-		virtual const std::string_view Name() const                                      = 0;
-		virtual constexpr std::span<const std::optional<std::uint8_t>> Signature() const = 0;
+		consteval SignatureLayout();
+
+		constexpr ScanSignature View() const
+		{
+			return {m_Values, m_Masks, m_SkipTable.data(), m_Anchor, m_SecondAnchor, m_Pair, m_HasAnchor};
+		}
 	};
 
-	template<Signature S>
-	class Pattern final : public IPattern
+	class IPattern
 	{
 	private:
 		const std::string_view m_Name;
-		std::array<std::optional<std::uint8_t>, S.ByteLength()> m_Signature;
+		const ScanSignature m_Signature;
+		const std::optional<SectionFilter> m_Filter;
+
+	protected:
+		constexpr IPattern(const std::string_view name, const ScanSignature& signature, const std::optional<SectionFilter>& filter) :
+		    m_Name(name),
+		    m_Signature(signature),
+		    m_Filter(filter)
+		{
+		}
 
 	public:
-		constexpr Pattern(const std::string_view name);
-
-		inline virtual const std::string_view Name() const override
+		constexpr const std::string_view Name() const
 		{
 			return m_Name;
 		}
-		inline virtual constexpr std::span<const std::optional<std::uint8_t>> Signature() const override
+		constexpr const ScanSignature& Signature() const
 		{
 			return m_Signature;
 		}
+		/**
+		 * @brief Sections this pattern is restricted to, the scanner's filter applies when there is none.
+		 */
+		constexpr const std::optional<SectionFilter>& Filter() const
+		{
+			return m_Filter;
+		}
+	};
 
-		friend std::ostream& operator<< <>(std::ostream& os, const Pattern<S>& signature);
+	template<Signature S>
+	class Pattern final : public IPattern
+	{
+	private:
+		static constexpr SignatureLayout<S> s_Layout{};
+
+	public:
+		constexpr Pattern(const std::string_view name) :
+		    IPattern(name, s_Layout.View(), std::nullopt)
+		{
+		}
+
+		constexpr Pattern(const std::string_view name, const SectionFilter& filter) :
+		    IPattern(name, s_Layout.View(), filter)
+		{
+		}
 	};
 
 	template<Signature S>
-	inline constexpr Pattern<S>::Pattern(const std::string_view name) :
-	    IPattern(),
-	    m_Name(name)
+	inline consteval SignatureLayout<S>::SignatureLayout()
 	{
 		for (size_t i = 0, pos = 0; i < S.Length(); i++)
 		{
@@ -102,30 +148,46 @@ namespace NewBase
 				if (S.Get()[i + 1] == '?')
 					i++;
 
-				m_Signature[pos++] = std::nullopt;
+				m_Values[pos]  = 0x00;
+				m_Masks[pos++] = 0x00;
 
 				continue;
 			}
 
 
-			m_Signature[pos++] = static_cast<std::uint8_t>(StrToHex(S.Get()[i]) * 0x10 + StrToHex(S.Get()[++i]));
+			const auto high = StrToHex(S.Get()[i]);
+			const auto low  = StrToHex(S.Get()[++i]);
+
+			m_Values[pos]  = static_cast<std::uint8_t>(high * 0x10 + low);
+			m_Masks[pos++] = 0xFF;
 		}
+
+		auto signature = ScanSignature{m_Values, m_Masks, nullptr, 0, 0, 0, false};
+		ScanKernel::SelectAnchors(signature);
+		ScanKernel::BuildSkipTable(signature, m_SkipTable);
+
+		m_Anchor       = signature.m_Anchor;
+		m_SecondAnchor = signature.m_SecondAnchor;
+		m_Pair         = signature.m_Pair;
+		m_HasAnchor    = signature.m_HasAnchor;
 	}
 
-	template<Signature S>
-	inline std::ostream& operator<<(std::ostream& os, const Pattern<S>& pattern)
+	inline std::ostream& operator<<(std::ostream& os, const IPattern& pattern)
 	{
+		const auto& signature = pattern.Signature();
+
 		os << pattern.Name() << ": { ";
-		for (const auto byte : pattern.Signature())
+		for (std::size_t i = 0; i < signature.Size(); ++i)
 		{
-			if (byte == std::nullopt)
+			if (!signature.m_Masks[i])
 			{
 				os << "?? ";
 				continue;
 			}
-			os << std::hex << std::uppercase << DWORD64(byte.value()) << std::nouppercase << std::dec << ' ';
+			constexpr char digits[] = "0123456789ABCDEF";
+			os << digits[signature.m_Values[i] >> 4] << digits[signature.m_Values[i] & 0xF] << ' ';
 		}
 		os << "}";
 		return os;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,134 @@
+#include "PatternCache.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace NewBase
+{
+	PatternCache::PatternCache(const std::filesystem::path& file, const ModuleIdentity& identity) :
+	    m_File(file),
+	    m_Identity(identity),
+	    m_Offsets(),
+	    m_Dirty(false)
+	{
+	}
+
+	bool PatternCache::Load()
+	{
+		std::ifstream file(m_File);
+		if (!file)
+			return false;
+
+		std::string magic;
+		int version = 0;
+		if (!(file >> magic >> version) || magic != s_Magic || version != s_Version)
+		{
+			LOG(WARNING) << "Ignoring offset cache with unknown format: " << m_File.string();
+			return false;
+		}
+
+		const auto identity = FormatIdentity(m_Identity);
+
+		bool found   = false;
+		bool inBuild = false;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.ends_with('\r'))
+				line.pop_back();
+
+			if (line.starts_with("build "))
+			{
+				inBuild = line.substr(6) == identity;
+				found |= inBuild;
+				continue;
+			}
+			if (!inBuild)
+				continue;
+
+			std::istringstream entry(line);
+			std::string name;
+			std::uint32_t rva;
+			if (entry >> name >> std::hex >> rva)
+				m_Offsets.insert_or_assign(std::move(name), rva);
+		}
+		return found;
+	}
+
+	bool PatternCache::Save()
+	{
+		if (!m_Dirty)
+			return true;
+
+		// blocks of other builds are carried over verbatim, a shipped table may cover many of them
+		const auto identity = FormatIdentity(m_Identity);
+
+		std::string others;
+		if (std::ifstream existing(m_File); existing)
+		{
+			std::string magic;
+			int version = 0;
+			if (existing >> magic >> version && magic == s_Magic && version == s_Version)
+			{
+				bool keep = false;
+				std::string line;
+				while (std::getline(existing, line))
+				{
+					if (line.ends_with('\r'))
+						line.pop_back();
+
+					if (line.starts_with("build "))
+						keep = line.substr(6) != identity;
+					if (keep)
+						others.append(line).push_back('\n');
+				}
+			}
+		}
+
+		std::ofstream file(m_File, std::ios::trunc);
+		if (!file)
+		{
+			LOG(WARNING) << "Failed to write offset cache: " << m_File.string();
+			return false;
+		}
+
+		file << s_Magic << ' ' << s_Version << '\n';
+		file << others;
+		file << "build " << identity << '\n';
+		file << std::hex << std::uppercase;
+		for (const auto& [name, rva] : m_Offsets)
+			file << name << ' ' << rva << '\n';
+
+		m_Dirty = false;
+		return static_cast<bool>(file);
+	}
+
+	std::optional<std::uint32_t> PatternCache::Get(const std::string_view name) const
+	{
+		if (const auto it = m_Offsets.find(std::string(name)); it != m_Offsets.end())
+			return it->second;
+
+		return std::nullopt;
+	}
+
+	void PatternCache::Set(const std::string_view name, std::uint32_t rva)
+	{
+		if (const auto it = m_Offsets.find(std::string(name)); it != m_Offsets.end() && it->second == rva)
+			return;
+
+		m_Offsets.insert_or_assign(std::string(name), rva);
+		m_Dirty = true;
+	}
+
+	std::string PatternCache::FormatIdentity(const ModuleIdentity& identity)
+	{
+		std::ostringstream stream;
+		stream << std::hex << std::uppercase << std::setfill('0');
+		stream << std::setw(8) << identity.m_TimeDateStamp << ' ' << std::setw(8) << identity.m_SizeOfImage << ' ';
+		for (const auto byte : identity.m_Guid)
+			stream << std::setw(2) << static_cast<int>(byte);
+		stream << ' ' << std::setw(8) << identity.m_Age;
+		return stream.str();
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Module.hpp"
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace NewBase
+{
+	/**
+	 * @brief Persists the RVA every pattern resolved to for one build of a module.
+	 * 
+	 * The file is plain text so it can be inspected and shipped with releases:
+	 *   YimASI-Offsets 1
+	 *   build <TimeDateStamp> <SizeOfImage> <GUID> <Age>
+	 *   <PatternName> <RVA> [extra columns are ignored]
+	 * A file may hold several build blocks, only the one matching the module identity is used and saving keeps the others intact.
+	 * The RVA is where the pattern matched, a loader verifies the bytes there and applies the pattern's arithmetic itself.
+	 */
+	class PatternCache
+	{
+	private:
+		static constexpr std::string_view s_Magic = "YimASI-Offsets";
+		static constexpr int s_Version            = 1;
+
+		const std::filesystem::path m_File;
+		const ModuleIdentity m_Identity;
+		std::map<std::string, std::uint32_t> m_Offsets;
+		bool m_Dirty;
+
+	public:
+		PatternCache(const std::filesystem::path& file, const ModuleIdentity& identity);
+
+		/**
+		 * @brief Reads the entries of the matching build from disk.
+		 * 
+		 * @return true If the file exists and contained a block for this build.
+		 */
+		bool Load();
+		/**
+		 * @brief Writes the current build back to disk if any entry changed since it was loaded.
+		 */
+		bool Save();
+
+		std::optional<std::uint32_t> Get(const std::string_view name) const;
+		void Set(const std::string_view name, std::uint32_t rva);
+
+		static std::string FormatIdentity(const ModuleIdentity& identity);
+	};
+}
@@ -1,36 +1,231 @@
 #include "PatternScanner.hpp"
 
 #include "Module.hpp"
+#include "MultiScanKernel.hpp"
+#include "PatternCache.hpp"
+#include "SuffixIndex.hpp"
+#include "filemgr/FileMgr.hpp"
+#include "util/WorkerPool.hpp"
 
-#include <future>
+#include <algorithm>
+#include <mutex>
 
 namespace NewBase
 {
 	PatternScanner::PatternScanner(const Module* module) :
 	    m_Module(module),
-	    m_Patterns()
+	    m_Patterns(),
+	    m_Cache(),
+	    m_Index(nullptr),
+	    m_Threads(WorkerPool::DefaultThreads() + 1),
+	    m_Filter(SectionFilter::Executable()),
+	    m_CheckUnique(false),
+	    m_Streaming(false)
 	{
 	}
 
+	PatternScanner::~PatternScanner() = default;
+
+	void PatternScanner::EnableCache()
+	{
+		if (!m_Module || !m_Module->Valid())
+			return;
+
+		const auto file = FileMgr::GetProjectFile(std::filesystem::path("./cache") / (std::string(m_Module->Name()) + ".offsets"));
+
+		m_Cache = std::make_unique<PatternCache>(file.Path(), m_Module->Identity());
+		m_Cache->Load();
+	}
+
+	void PatternScanner::SetIndex(const SuffixIndex* index)
+	{
+		m_Index = index;
+	}
+
+	void PatternScanner::SetThreads(std::size_t threads)
+	{
+		m_Threads = std::max<std::size_t>(threads, 1);
+	}
+
+	void PatternScanner::SetSectionFilter(const SectionFilter& filter)
+	{
+		m_Filter = filter;
+	}
+
+	void PatternScanner::SetUniqueCheck(bool enabled)
+	{
+		m_CheckUnique = enabled;
+	}
+
+	void PatternScanner::SetStreaming(bool enabled)
+	{
+		m_Streaming = enabled;
+	}
+
+	std::vector<PatternMatches> PatternScanner::FindAll(std::size_t maxMatches) const
+	{
+		std::vector<PatternMatches> matches;
+		if (!m_Module || !m_Module->Valid())
+			return matches;
+
+		std::vector<ScanSignature> signatures;
+		signatures.reserve(m_Patterns.size());
+		for (const auto& [pattern, func] : m_Patterns)
+		{
+			signatures.push_back(pattern->Signature());
+			matches.push_back({pattern, 0, {}});
+		}
+
+		if (!m_Patterns.empty())
+			FindAllChunks(MultiScanKernel(std::move(signatures)), matches, maxMatches);
+		return matches;
+	}
+
+	void PatternScanner::FindAll(const PatternMatchFunc& func, std::size_t maxMatches) const
+	{
+		for (const auto& match : FindAll(maxMatches))
+		{
+			for (const auto address : match.m_Addresses)
+				std::invoke(func, match.m_Pattern, address);
+		}
+	}
+
 	bool PatternScanner::Scan()
 	{
 		if (!m_Module || !m_Module->Valid())
 			return false;
 
-		std::vector<std::future<bool>> jobs;
+		std::vector<ScanSignature> signatures;
+		signatures.reserve(m_Patterns.size());
 		for (const auto& [pattern, func] : m_Patterns)
+			signatures.push_back(pattern->Signature());
+
+		const auto begin = reinterpret_cast<const std::uint8_t*>(m_Module->Base());
+
+		std::vector<const std::uint8_t*> results(m_Patterns.size());
+		std::vector<std::uint8_t> streamed(m_Patterns.size()); // per group, written by the scanning threads
+
+		if (m_CheckUnique)
+		{
+			// the lowest match is exactly what the first match scan would have found
+			std::vector<PatternMatches> matches;
+			for (const auto& [pattern, func] : m_Patterns)
+				matches.push_back({pattern, 0, {}});
+			FindAllChunks(MultiScanKernel(std::move(signatures)), matches, 1);
+
+			for (std::size_t i = 0; i < matches.size(); ++i)
+			{
+				if (matches[i].m_Count > 1)
+				{
+					LOG(WARNING) << "Pattern [" << matches[i].m_Pattern->Name() << "] is not unique, found " << matches[i].m_Count << " matches.";
+				}
+				if (!matches[i].m_Addresses.empty())
+					results[i] = reinterpret_cast<const std::uint8_t*>(matches[i].m_Addresses.front());
+			}
+		}
+		else
 		{
-			jobs.emplace_back(std::async(&PatternScanner::ScanInternal, this, pattern, func));
+			std::size_t cached = 0;
+			for (std::size_t i = 0; m_Cache && i < m_Patterns.size(); ++i)
+			{
+				const auto rva = m_Cache->Get(m_Patterns[i].first->Name());
+				if (!rva || !InFilteredSection(m_Patterns[i].first, *rva))
+					continue;
+
+				if (ScanKernel::Matches(begin + *rva, signatures[i]))
+				{
+					results[i] = begin + *rva;
+					cached++;
+				}
+			}
+			if (m_Cache)
+			{
+				LOG(INFO) << "Resolved " << cached << "/" << m_Patterns.size() << " patterns from the offset cache.";
+			}
+
+			// a group is settled once one alternative is known, the index answers definitively for the groups it covers
+			std::vector<bool> settled(m_Patterns.size());
+			bool pending = false;
+			for (std::size_t group = 0; group < m_Patterns.size(); group = GroupEnd(group))
+			{
+				const auto end = GroupEnd(group);
+
+				auto known = std::any_of(results.begin() + group, results.begin() + end, std::identity{});
+				if (!known && m_Index)
+				{
+					const auto covered = std::all_of(m_Patterns.begin() + group, m_Patterns.begin() + end, [this](const auto& entry) {
+						return m_Index->Covers(FilterFor(entry.first));
+					});
+					for (auto i = group; covered && i < end; ++i)
+					{
+						results[i] = m_Index->FindFirst(signatures[i], FilterFor(m_Patterns[i].first));
+						if (results[i])
+							break;
+					}
+					known = covered;
+				}
+
+				std::fill(settled.begin() + group, settled.begin() + end, known);
+				pending |= !known;
+			}
+
+			if (m_Streaming)
+			{
+				for (std::size_t group = 0; group < m_Patterns.size(); group = GroupEnd(group))
+				{
+					const auto winner = GroupWinner(results, group);
+					if (winner != GroupEnd(group))
+					{
+						Resolve(m_Patterns[winner].first, m_Patterns[winner].second, results[winner]);
+						streamed[group] = true;
+					}
+				}
+			}
+
+			if (pending)
+			{
+				FinalFunc onFinal;
+				if (m_Streaming)
+				{
+					onFinal = [this, &streamed](std::size_t index, const std::uint8_t* match) {
+						Resolve(m_Patterns[index].first, m_Patterns[index].second, match);
+						streamed[m_GroupBegins[index]] = true;
+					};
+				}
+				ScanChunks(MultiScanKernel(std::move(signatures)), results, settled, onFinal);
+			}
 		}
 
 		bool scanSuccess = true;
-		for (auto& job : jobs)
+		for (std::size_t group = 0; group < m_Patterns.size(); group = GroupEnd(group))
 		{
-			job.wait();
+			// the highest priority alternative that matched wins, lower ones may have been found before they were cancelled
+			const auto end    = GroupEnd(group);
+			const auto winner = GroupWinner(results, group);
+			if (winner == end)
+			{
+				Resolve(m_Patterns[group].first, m_Patterns[group].second, nullptr);
+				if (end - group > 1)
+				{
+					LOG(WARNING) << "None of the " << end - group << " alternatives of [" << m_Patterns[group].first->Name() << "] matched.";
+				}
+				scanSuccess = false;
+				continue;
+			}
 
-			if (scanSuccess)
-				scanSuccess = job.get();
+			if (winner != group)
+			{
+				LOG(INFO) << "Pattern [" << m_Patterns[winner].first->Name() << "] stands in for [" << m_Patterns[group].first->Name() << "].";
+			}
+			if (m_Cache)
+				m_Cache->Set(m_Patterns[winner].first->Name(), static_cast<std::uint32_t>(results[winner] - begin));
+
+			if (!streamed[group])
+				Resolve(m_Patterns[winner].first, m_Patterns[winner].second, results[winner]);
 		}
+		if (m_Cache)
+			m_Cache->Save();
+
 		if (!scanSuccess)
 		{
 			LOG(FATAL) << "Some patterns have not been found, continuing would be foolish.";
@@ -38,36 +233,204 @@ namespace NewBase
 		return scanSuccess;
 	}
 
-	bool PatternScanner::ScanInternal(const IPattern* pattern, PatternFunc func) const
+	const SectionFilter& PatternScanner::FilterFor(const IPattern* pattern) const
 	{
-		const auto signature = pattern->Signature();
+		return pattern->Filter() ? *pattern->Filter() : m_Filter;
+	}
 
-		for (auto i = m_Module->Base(); i < m_Module->End(); ++i)
+	bool PatternScanner::InFilteredSection(const IPattern* pattern, std::uintptr_t rva) const
+	{
+		const auto& filter = FilterFor(pattern);
+		for (const auto& section : m_Module->Sections())
 		{
-			if (signature.size() + i > m_Module->End())
-				break;
+			if (rva >= section.m_Rva && rva - section.m_Rva + pattern->Signature().Size() <= section.m_Size)
+				return filter.Matches(section);
+		}
+		return false;
+	}
 
-			const auto instruction = reinterpret_cast<std::uint8_t*>(i);
-			bool found             = true;
-			for (std::size_t instructionIdx = 0; instructionIdx < signature.size(); ++instructionIdx)
+	std::size_t PatternScanner::GroupEnd(std::size_t begin) const
+	{
+		auto end = begin + 1;
+		while (end < m_GroupBegins.size() && m_GroupBegins[end] == begin)
+			end++;
+		return end;
+	}
+
+	std::size_t PatternScanner::GroupWinner(std::span<const std::uint8_t* const> results, std::size_t group) const
+	{
+		const auto end = GroupEnd(group);
+		return static_cast<std::size_t>(std::find_if(results.begin() + group, results.begin() + end, std::identity{}) - results.begin());
+	}
+
+	void PatternScanner::ForEachChunk(std::size_t overlap, const std::vector<bool>& settled, const ChunkFunc& func) const
+	{
+		const auto& sections = m_Module->Sections();
+
+		// the queued chunks reference these, reserve so they never move
+		std::vector<std::vector<bool>> applicable;
+		applicable.reserve(sections.size());
+
+		std::size_t chunks = 0;
+		WorkerPool pool(m_Threads - 1);
+		for (const auto& section : sections)
+		{
+			auto& applies = applicable.emplace_back(settled.size());
+
+			bool wanted = false;
+			for (std::size_t i = 0; i < settled.size(); ++i)
 			{
-				if (signature[instructionIdx] && signature[instructionIdx].value() != instruction[instructionIdx])
-				{
-					found = false;
-				}
+				applies[i] = FilterFor(m_Patterns[i].first).Matches(section);
+				wanted |= applies[i] && !settled[i];
 			}
+			if (!wanted)
+				continue;
 
-			if (found)
+			// matches never straddle two sections, the section end bounds every read
+			const auto begin = reinterpret_cast<const std::uint8_t*>(m_Module->Base() + section.m_Rva);
+			const auto end   = begin + section.m_Size;
+			for (auto chunk = begin; chunk < end;)
 			{
-				LOG(INFO) << "Found pattern [" << pattern->Name() << "] : [" << HEX(i) << "]";
+				const auto chunkEnd = chunk + std::min<std::size_t>(s_ChunkSize, end - chunk);
+				const auto limit    = chunkEnd + std::min<std::size_t>(overlap, end - chunkEnd);
 
-				std::invoke(func, i);
+				pool.Push([&func, &applies, index = chunks++, chunk, chunkEnd, limit] {
+					func(index, applies, chunk, chunkEnd, limit);
+				});
 
-				return true;
+				chunk = chunkEnd;
 			}
 		}
+		pool.Wait();
+	}
+
+	void PatternScanner::ScanChunks(const MultiScanKernel& kernel, std::span<const std::uint8_t*> results, const std::vector<bool>& settled, const FinalFunc& onFinal) const
+	{
+		// every pattern keeps the lowest match any chunk reported, chunks past it have nothing left to find for that pattern
+		std::vector<std::atomic<std::uintptr_t>> best(results.size());
+		for (std::size_t i = 0; i < results.size(); ++i)
+			best[i] = settled[i] ? 0 : UINTPTR_MAX;
+
+		// an alternative is cancelled as soon as one with a higher priority has been found anywhere
+		const auto cancelled = [this, &best](std::size_t i) {
+			for (auto j = m_GroupBegins[i]; j < i; ++j)
+			{
+				if (best[j].load(std::memory_order_relaxed) != UINTPTR_MAX)
+					return true;
+			}
+			return false;
+		};
+
+		// chunks are numbered in address order, a match is final once every chunk in front of the one that reported it has finished
+		std::mutex progressMutex;
+		std::vector<std::size_t> bestChunk(results.size());
+		std::vector<bool> finished;
+		std::size_t firstUnfinished = 0;
+		std::vector<bool> reported(results.size());
+
+		ForEachChunk(kernel.MaxLength() - 1, settled, [&](std::size_t index, const std::vector<bool>& applies, const std::uint8_t* chunk, const std::uint8_t* chunkEnd, const std::uint8_t* limit) {
+			const auto chunkStart = reinterpret_cast<std::uintptr_t>(chunk);
+
+			std::vector<const std::uint8_t*> found(best.size());
+			std::vector<bool> skipped(best.size());
+			for (std::size_t i = 0; i < best.size(); ++i)
+			{
+				skipped[i] = !applies[i] || best[i].load(std::memory_order_relaxed) < chunkStart || cancelled(i);
+				found[i]   = skipped[i] ? chunk : nullptr;
+			}
+			if (!std::ranges::all_of(skipped, std::identity{}))
+				kernel.FindFirst(chunk, chunkEnd, limit, found);
+
+			std::vector<std::pair<std::size_t, const std::uint8_t*>> finals;
+			{
+				std::lock_guard lock(progressMutex);
+				for (std::size_t i = 0; i < found.size(); ++i)
+				{
+					const auto address = reinterpret_cast<std::uintptr_t>(found[i]);
+					if (skipped[i] || !found[i] || address >= best[i].load(std::memory_order_relaxed))
+						continue;
+
+					best[i].store(address, std::memory_order_relaxed);
+					bestChunk[i] = index;
+				}
+
+				if (finished.size() <= index)
+					finished.resize(index + 1);
+				finished[index] = true;
+				while (firstUnfinished < finished.size() && finished[firstUnfinished])
+					firstUnfinished++;
+
+				// only the first alternative of a group can be final early, the others depend on it never matching
+				for (std::size_t group = 0; onFinal && group < best.size(); group = GroupEnd(group))
+				{
+					if (reported[group] || settled[group] || best[group].load(std::memory_order_relaxed) == UINTPTR_MAX || bestChunk[group] >= firstUnfinished)
+						continue;
+
+					reported[group] = true;
+					finals.emplace_back(group, reinterpret_cast<const std::uint8_t*>(best[group].load(std::memory_order_relaxed)));
+				}
+			}
+
+			for (const auto& [pattern, match] : finals)
+				onFinal(pattern, match);
+		});
+
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			if (!settled[i] && best[i] != UINTPTR_MAX)
+				results[i] = reinterpret_cast<const std::uint8_t*>(best[i].load());
+		}
+	}
+
+	void PatternScanner::FindAllChunks(const MultiScanKernel& kernel, std::span<PatternMatches> matches, std::size_t maxMatches) const
+	{
+		std::mutex mutex;
+		const std::vector<bool> pending(matches.size());
+
+		ForEachChunk(kernel.MaxLength() - 1, pending, [&kernel, &mutex, matches, maxMatches](std::size_t, const std::vector<bool>& applies, const std::uint8_t* chunk, const std::uint8_t* chunkEnd, const std::uint8_t* limit) {
+			std::vector<bool> skipped(applies.size());
+			for (std::size_t i = 0; i < applies.size(); ++i)
+				skipped[i] = !applies[i];
+
+			// a chunk reports ascending matches, only its first maxMatches can end up among the lowest overall
+			std::vector<std::size_t> counts(applies.size());
+			std::vector<std::pair<std::size_t, std::uintptr_t>> found;
+			kernel.FindAll(chunk, chunkEnd, limit, skipped, [&counts, &found, maxMatches](std::size_t index, const std::uint8_t* match) {
+				if (counts[index]++ < maxMatches)
+					found.emplace_back(index, reinterpret_cast<std::uintptr_t>(match));
+			});
+			// maxMatches of zero keeps no addresses but still counts them
+			if (std::ranges::none_of(counts, std::identity{}))
+				return;
+
+			std::lock_guard lock(mutex);
+			for (std::size_t i = 0; i < counts.size(); ++i)
+				matches[i].m_Count += counts[i];
+			for (const auto& [index, address] : found)
+				matches[index].m_Addresses.push_back(address);
+		});
+
+		for (auto& match : matches)
+		{
+			std::ranges::sort(match.m_Addresses);
+			if (match.m_Addresses.size() > maxMatches)
+				match.m_Addresses.resize(maxMatches);
+		}
+	}
+
+	bool PatternScanner::Resolve(const IPattern* pattern, const PatternFunc& func, const std::uint8_t* match) const
+	{
+		if (match)
+		{
+			const auto address = reinterpret_cast<std::uintptr_t>(match);
+			LOG(INFO) << "Found pattern [" << pattern->Name() << "] : [" << HEX(address) << "]";
+
+			std::invoke(func, address);
+
+			return true;
+		}
 
 		LOG(WARNING) << "Failed to find pattern [" << pattern->Name() << "]";
 		return false;
 	}
-}
\ No newline at end of file
+}
@@ -3,33 +3,136 @@
 #include "PointerCalculator.hpp"
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace NewBase
 {
 	class Module;
-	using PatternFunc = std::function<void(PointerCalculator)>;
+	class MultiScanKernel;
+	class PatternCache;
+	class SuffixIndex;
+	using PatternFunc      = std::function<void(PointerCalculator)>;
+	using PatternMatchFunc = std::function<void(const IPattern* pattern, std::uintptr_t address)>;
+
+	/**
+	 * @brief One candidate signature for a pointer, with the post-processing that applies when this candidate is the one that matched.
+	 */
+	struct PatternAlternative
+	{
+		const IPattern& m_Pattern;
+		PatternFunc m_Func;
+	};
+
+	struct PatternMatches
+	{
+		const IPattern* m_Pattern;
+		std::size_t m_Count;                    // every match in the scanned sections, even past the cap
+		std::vector<std::uintptr_t> m_Addresses; // the lowest matches in ascending order, at most the cap
+	};
 
 	class PatternScanner
 	{
 	private:
 		const Module* m_Module;
 		std::vector<std::pair<const IPattern*, PatternFunc>> m_Patterns;
+		std::vector<std::size_t> m_GroupBegins; // per pattern, index of the first alternative of its group
+		std::unique_ptr<PatternCache> m_Cache;
+		const SuffixIndex* m_Index;
+		std::size_t m_Threads;
+		SectionFilter m_Filter;
+		bool m_CheckUnique;
+		bool m_Streaming;
+
+		static constexpr std::size_t s_ChunkSize = 1 << 20;
 
 	public:
 		PatternScanner(const Module* module);
+		~PatternScanner();
 
-		template<Signature S>
-		void Add(const Pattern<S>& pattern, const PatternFunc& func);
+		void Add(const IPattern& pattern, const PatternFunc& func);
+		/**
+		 * @brief Adds signatures that each find the same pointer, highest priority first, to be scanned in the same pass as the rest.
+		 * Only the highest priority alternative that matches gets its func called, once one matches the scan stops looking for those after it.
+		 */
+		void AddAlternatives(std::initializer_list<PatternAlternative> alternatives);
 		bool Scan();
 
+		/**
+		 * @brief Finds every match of every added pattern instead of only the first, the cache is neither read nor written.
+		 *
+		 * @param maxMatches Most addresses kept per pattern, the match count is always complete
+		 */
+		std::vector<PatternMatches> FindAll(std::size_t maxMatches = SIZE_MAX) const;
+		/**
+		 * @brief Calls func for every match once the whole module was scanned, grouped by pattern in the order they were added and ascending per pattern.
+		 */
+		void FindAll(const PatternMatchFunc& func, std::size_t maxMatches = SIZE_MAX) const;
+
+		/**
+		 * @brief Remembers the RVA of every found pattern in a file under the FileMgr root.
+		 * Later scans of the same module build only verify the cached offsets and skip the full scan when they still match.
+		 */
+		void EnableCache();
+
+		/**
+		 * @brief Answers patterns from a prebuilt index of the module instead of scanning, as long as it covers their sections.
+		 * The index has to outlive the scanner, nullptr goes back to scanning.
+		 */
+		void SetIndex(const SuffixIndex* index);
+
+		/**
+		 * @brief Amount of threads a scan may occupy, including the calling thread. Defaults to every hardware thread.
+		 */
+		void SetThreads(std::size_t threads);
+
+		/**
+		 * @brief Sections searched for patterns that do not bring their own filter. Defaults to executable sections.
+		 */
+		void SetSectionFilter(const SectionFilter& filter);
+
+		/**
+		 * @brief Makes Scan look for every match and warn about patterns which are not unique.
+		 * Always scans the whole module, the first match is still the one that gets resolved.
+		 */
+		void SetUniqueCheck(bool enabled);
+
+		/**
+		 * @brief Calls the func of every pattern as soon as its match is final, from whichever scanning thread finalized it.
+		 * Lets slow post-processing overlap with the rest of the scan, every func has to be safe to call from any thread.
+		 * Patterns that are not found and lower priority alternatives are still resolved on the calling thread at the end.
+		 */
+		void SetStreaming(bool enabled);
+
 	private:
-		bool ScanInternal(const IPattern* pattern, PatternFunc func) const;
+		const SectionFilter& FilterFor(const IPattern* pattern) const;
+		bool InFilteredSection(const IPattern* pattern, std::uintptr_t rva) const;
+		using ChunkFunc = std::function<void(std::size_t index, const std::vector<bool>& applies, const std::uint8_t* chunk, const std::uint8_t* chunkEnd, const std::uint8_t* limit)>;
+		using FinalFunc = std::function<void(std::size_t index, const std::uint8_t* match)>;
+		void ForEachChunk(std::size_t overlap, const std::vector<bool>& settled, const ChunkFunc& func) const;
+		std::size_t GroupEnd(std::size_t begin) const;
+		/**
+		 * @return std::size_t Index of the highest priority alternative of the group that matched, GroupEnd(group) if none did
+		 */
+		std::size_t GroupWinner(std::span<const std::uint8_t* const> results, std::size_t group) const;
+		void ScanChunks(const MultiScanKernel& kernel, std::span<const std::uint8_t*> results, const std::vector<bool>& settled, const FinalFunc& onFinal) const;
+		void FindAllChunks(const MultiScanKernel& kernel, std::span<PatternMatches> matches, std::size_t maxMatches) const;
+		bool Resolve(const IPattern* pattern, const PatternFunc& func, const std::uint8_t* match) const;
 	};
 
-	template<Signature S>
-	inline void PatternScanner::Add(const Pattern<S>& pattern, const PatternFunc& func)
+	inline void PatternScanner::Add(const IPattern& pattern, const PatternFunc& func)
 	{
+		m_GroupBegins.push_back(m_Patterns.size());
 		m_Patterns.push_back(std::move(std::make_pair(&pattern, func)));
 	}
+
+	inline void PatternScanner::AddAlternatives(std::initializer_list<PatternAlternative> alternatives)
+	{
+		const auto begin = m_Patterns.size();
+		for (const auto& alternative : alternatives)
+		{
+			m_GroupBegins.push_back(begin);
+			m_Patterns.emplace_back(&alternative.m_Pattern, alternative.m_Func);
+		}
+	}
 }
@@ -0,0 +1,296 @@
+#include "PdbSymbols.hpp"
+
+#include <algorithm>
+
+namespace NewBase
+{
+	static constexpr std::string_view s_MsfMagic = {"Microsoft C/C++ MSF 7.00\r\n\x1A" "DS\0\0\0", 32};
+
+	static constexpr std::size_t s_PdbInfoStream = 1;
+	static constexpr std::size_t s_DbiStream     = 3;
+
+	static constexpr std::uint32_t s_ContributionsV60 = 0xEFFE0000 + 19970605;
+	static constexpr std::uint32_t s_ContributionsV2  = 0xEFFE0000 + 20140516;
+	static constexpr std::uint16_t s_PublicSymbol     = 0x110E; // S_PUB32
+	static constexpr std::size_t s_SectionHeaderDebug = 5;      // slot of the section header stream in the optional debug header
+
+	template<typename T>
+	static bool ReadAt(std::span<const std::uint8_t> data, std::size_t offset, T& value)
+	{
+		if (offset > data.size() || data.size() - offset < sizeof(T))
+			return false;
+
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		return true;
+	}
+
+	PdbSymbols::PdbSymbols() :
+	    m_File(),
+	    m_BlockSize(0),
+	    m_Guid(),
+	    m_Age(0)
+	{
+	}
+
+	bool PdbSymbols::Load(const std::filesystem::path& file)
+	{
+		if (!m_File.Open(file) || !ReadDirectory())
+			return false;
+
+		// the PDB info stream carries the GUID, the DBI stream the age the CodeView record was written with
+		const auto info = Stream(s_PdbInfoStream);
+		if (!ReadAt(info, 8, m_Age) || info.size() < 12 + m_Guid.size())
+			return false;
+		std::memcpy(m_Guid.data(), info.data() + 12, m_Guid.size());
+
+		const auto dbi = Stream(s_DbiStream);
+		std::int32_t versionSignature = 0;
+		std::uint16_t publicStream = 0, recordStream = 0;
+		std::int32_t modules = 0, contributions = 0;
+		if (!ReadAt(dbi, 0, versionSignature) || versionSignature != -1 || !ReadAt(dbi, 8, m_Age) || !ReadAt(dbi, 16, publicStream)
+		    || !ReadAt(dbi, 20, recordStream) || !ReadAt(dbi, 24, modules) || !ReadAt(dbi, 28, contributions) || modules < 0 || contributions < 0
+		    || dbi.size() < 64ull + modules + contributions)
+			return false;
+
+		ReadSectionHeaders(dbi);
+		ReadContributions(dbi.subspan(64 + modules, contributions));
+		ReadPublics(Stream(publicStream), Stream(recordStream));
+
+		LOG(INFO) << "Indexed " << m_Symbols.size() << " symbols from " << file.filename().string() << ".";
+		return true;
+	}
+
+	bool PdbSymbols::Matches(const ModuleIdentity& identity) const
+	{
+		return m_BlockSize && identity.m_Guid == m_Guid && identity.m_Age == m_Age;
+	}
+
+	std::optional<std::uint32_t> PdbSymbols::Find(std::string_view name) const
+	{
+		if (const auto it = m_Symbols.find(name); it != m_Symbols.end() && it->second != s_Ambiguous)
+			return it->second;
+		return std::nullopt;
+	}
+
+	const PdbSymbols::Contribution* PdbSymbols::FindContribution(std::uint32_t rva) const
+	{
+		const auto it = std::ranges::upper_bound(m_Contributions, rva, {}, &Contribution::m_Rva);
+		if (it == m_Contributions.begin() || rva - std::prev(it)->m_Rva >= std::prev(it)->m_Size)
+			return nullptr;
+		return &*std::prev(it);
+	}
+
+	bool PdbSymbols::ReadDirectory()
+	{
+		const auto file = m_File.Data();
+		if (file.size() < s_MsfMagic.size() + 24 || std::memcmp(file.data(), s_MsfMagic.data(), s_MsfMagic.size()))
+			return false;
+
+		std::uint32_t blockSize = 0, blocks = 0, directoryBytes = 0, blockMap = 0;
+		ReadAt(file, 32, blockSize);
+		ReadAt(file, 40, blocks);
+		ReadAt(file, 44, directoryBytes);
+		ReadAt(file, 52, blockMap);
+		if (!blockSize || blockSize & (blockSize - 1) || static_cast<std::uint64_t>(blocks) * blockSize > file.size())
+			return false;
+		m_BlockSize = blockSize;
+
+		// the block map lists the blocks of the directory, which lists the blocks of every stream
+		const auto directoryBlocks = (directoryBytes + blockSize - 1) / blockSize;
+		const auto map             = Block(blockMap);
+		if (map.size() / sizeof(std::uint32_t) < directoryBlocks)
+			return false;
+
+		std::vector<std::uint8_t> directory;
+		directory.reserve(directoryBlocks * blockSize);
+		for (std::uint32_t i = 0; i < directoryBlocks; i++)
+		{
+			std::uint32_t index = 0;
+			ReadAt(map, i * sizeof(index), index);
+
+			const auto block = Block(index);
+			if (block.empty())
+				return false;
+			directory.insert(directory.end(), block.begin(), block.end());
+		}
+		directory.resize(std::min<std::size_t>(directory.size(), directoryBytes));
+
+		std::uint32_t streams = 0;
+		if (!ReadAt<std::uint32_t>(directory, 0, streams) || directory.size() / sizeof(std::uint32_t) < 1ull + streams)
+			return false;
+
+		std::size_t offset = sizeof(std::uint32_t) * (1ull + streams);
+		m_StreamSizes.resize(streams);
+		m_StreamBlocks.resize(streams);
+		for (std::uint32_t i = 0; i < streams; i++)
+		{
+			ReadAt<std::uint32_t>(directory, sizeof(std::uint32_t) * (1ull + i), m_StreamSizes[i]);
+			if (m_StreamSizes[i] == UINT32_MAX) // deleted stream
+				m_StreamSizes[i] = 0;
+
+			const auto count = (m_StreamSizes[i] + blockSize - 1) / blockSize;
+			if ((directory.size() - offset) / sizeof(std::uint32_t) < count)
+				return false;
+
+			m_StreamBlocks[i].resize(count);
+			if (count)
+				std::memcpy(m_StreamBlocks[i].data(), directory.data() + offset, count * sizeof(std::uint32_t));
+			offset += count * sizeof(std::uint32_t);
+		}
+		return true;
+	}
+
+	std::span<const std::uint8_t> PdbSymbols::Stream(std::size_t index)
+	{
+		if (index >= m_StreamBlocks.size() || m_StreamBlocks[index].empty())
+			return {};
+
+		const auto& blocks = m_StreamBlocks[index];
+		const auto size    = m_StreamSizes[index];
+
+		const auto adjacent = std::ranges::adjacent_find(blocks, [](std::uint32_t a, std::uint32_t b) {
+			return b != a + 1;
+		}) == blocks.end();
+		if (adjacent)
+		{
+			const auto first = Block(blocks.front());
+			const auto last  = Block(blocks.back());
+			if (first.empty() || last.empty())
+				return {};
+			return {first.data(), size};
+		}
+
+		auto& copy = m_Copies.emplace_back();
+		copy.reserve(blocks.size() * m_BlockSize);
+		for (const auto index : blocks)
+		{
+			const auto block = Block(index);
+			if (block.empty())
+				return {};
+			copy.insert(copy.end(), block.begin(), block.end());
+		}
+		copy.resize(size);
+		return copy;
+	}
+
+	std::span<const std::uint8_t> PdbSymbols::Block(std::uint32_t index) const
+	{
+		const auto file = m_File.Data();
+		if (static_cast<std::uint64_t>(index) * m_BlockSize + m_BlockSize > file.size())
+			return {};
+		return file.subspan(static_cast<std::size_t>(index) * m_BlockSize, m_BlockSize);
+	}
+
+	void PdbSymbols::ReadSectionHeaders(std::span<const std::uint8_t> dbi)
+	{
+		// the optional debug header is the last substream, it lists streams by kind
+		std::int32_t sizes[6]{};
+		std::int32_t debugHeaderSize = 0;
+		std::size_t offset = 64;
+		for (std::size_t i = 0; i < std::size(sizes); i++)
+		{
+			if (!ReadAt(dbi, 24 + i * sizeof(std::int32_t), sizes[i]) || sizes[i] < 0)
+				return;
+		}
+		if (!ReadAt(dbi, 48, debugHeaderSize) || !ReadAt(dbi, 52, sizes[5]) || sizes[5] < 0)
+			return;
+		for (const auto size : sizes)
+			offset += size;
+
+		std::uint16_t stream = 0;
+		if (debugHeaderSize < static_cast<std::int32_t>((s_SectionHeaderDebug + 1) * sizeof(stream)) || !ReadAt(dbi, offset + s_SectionHeaderDebug * sizeof(stream), stream))
+			return;
+
+		const auto headers = Stream(stream);
+		for (std::size_t at = 0; at + sizeof(IMAGE_SECTION_HEADER) <= headers.size(); at += sizeof(IMAGE_SECTION_HEADER))
+		{
+			IMAGE_SECTION_HEADER header{};
+			ReadAt(headers, at, header);
+			m_SectionRvas.push_back(header.VirtualAddress);
+		}
+	}
+
+	void PdbSymbols::ReadContributions(std::span<const std::uint8_t> contributions)
+	{
+		std::uint32_t version = 0;
+		if (!ReadAt(contributions, 0, version) || (version != s_ContributionsV60 && version != s_ContributionsV2))
+			return;
+
+		const std::size_t entrySize = version == s_ContributionsV2 ? 32 : 28;
+		for (std::size_t at = sizeof(version); at + entrySize <= contributions.size(); at += entrySize)
+		{
+			std::uint16_t section = 0, module = 0;
+			std::int32_t offset = 0, size = 0;
+			std::uint32_t characteristics = 0;
+			ReadAt(contributions, at, section);
+			ReadAt(contributions, at + 4, offset);
+			ReadAt(contributions, at + 8, size);
+			ReadAt(contributions, at + 12, characteristics);
+			ReadAt(contributions, at + 16, module);
+			if (!section || section > m_SectionRvas.size() || offset < 0 || size <= 0)
+				continue;
+
+			m_Contributions.push_back({m_SectionRvas[section - 1] + static_cast<std::uint32_t>(offset), static_cast<std::uint32_t>(size), characteristics, module});
+		}
+		std::ranges::sort(m_Contributions, {}, &Contribution::m_Rva);
+	}
+
+	void PdbSymbols::ReadPublics(std::span<const std::uint8_t> publics, std::span<const std::uint8_t> records)
+	{
+		const auto readRecord = [this, records](std::size_t at) {
+			std::uint16_t length = 0, kind = 0, section = 0;
+			std::uint32_t offset = 0;
+			if (!ReadAt(records, at, length) || !ReadAt(records, at + 2, kind) || kind != s_PublicSymbol || length < 12
+			    || !ReadAt(records, at + 8, offset) || !ReadAt(records, at + 12, section) || !section || section > m_SectionRvas.size())
+				return;
+
+			const auto name = reinterpret_cast<const char*>(records.data() + at + 14);
+			const auto end  = std::min<std::size_t>(at + 2 + length, records.size());
+			AddSymbol({name, strnlen(name, end - (at + 14))}, m_SectionRvas[section - 1] + offset);
+		};
+
+		// the publics stream hashes every S_PUB32 by name, its hash records point into the symbol record stream
+		constexpr std::size_t publicsHeader = 28;
+		std::uint32_t signature = 0, hashRecords = 0;
+		if (ReadAt(publics, publicsHeader, signature) && signature == UINT32_MAX && ReadAt(publics, publicsHeader + 8, hashRecords))
+		{
+			const auto first = publicsHeader + 16;
+			m_Symbols.reserve(hashRecords / 8 * 2);
+			for (std::size_t at = first; at + 8 <= first + hashRecords && at + 8 <= publics.size(); at += 8)
+			{
+				std::int32_t offset = 0;
+				ReadAt(publics, at, offset);
+				if (offset > 0)
+					readRecord(offset - 1);
+			}
+			return;
+		}
+
+		// without a publics stream every record has to be looked at
+		for (std::size_t at = 0; at + 4 <= records.size();)
+		{
+			std::uint16_t length = 0;
+			ReadAt(records, at, length);
+			readRecord(at);
+			at += 2 + length;
+		}
+	}
+
+	void PdbSymbols::AddSymbol(std::string_view name, std::uint32_t rva)
+	{
+		const auto add = [this, rva](std::string_view key) {
+			const auto [it, inserted] = m_Symbols.emplace(key, rva);
+			if (!inserted && it->second != rva)
+				it->second = s_Ambiguous;
+		};
+		add(name);
+
+		// ?Name@Scope@@... also answers to Name, ?? and ?$ are operators, constructors and templates
+		if (name.size() > 2 && name[0] == '?' && name[1] != '?' && name[1] != '$')
+		{
+			const auto end = name.find('@');
+			if (end != std::string_view::npos && end > 1)
+				add(name.substr(1, end - 1));
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Module.hpp"
+#include "util/MappedFile.hpp"
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace NewBase
+{
+	/**
+	 * @brief Public symbols and section contributions of a PDB, read straight from a memory mapped MSF file.
+	 *
+	 * Symbols are looked up by their exact public name and, for MSVC decorated names, by the unqualified identifier at
+	 * their start as long as no other symbol shares it. Lookups are a single hash probe however large the image is,
+	 * a matching PDB therefore beats scanning for every function it names.
+	 */
+	class PdbSymbols
+	{
+	public:
+		struct Contribution
+		{
+			std::uint32_t m_Rva;
+			std::uint32_t m_Size;
+			std::uint32_t m_Characteristics;
+			std::uint16_t m_Module; // index of the compiland in the DBI module list
+		};
+
+	private:
+		MappedFile m_File;
+		std::uint32_t m_BlockSize;
+		std::vector<std::uint32_t> m_StreamSizes;
+		std::vector<std::vector<std::uint32_t>> m_StreamBlocks;
+		std::vector<std::vector<std::uint8_t>> m_Copies; // streams whose blocks are not adjacent in the file
+
+		std::array<std::uint8_t, 16> m_Guid;
+		std::uint32_t m_Age;
+		std::vector<std::uint32_t> m_SectionRvas;
+		std::unordered_map<std::string_view, std::uint32_t> m_Symbols; // name to RVA, s_Ambiguous for shared short names
+		std::vector<Contribution> m_Contributions;                     // sorted by RVA
+
+		static constexpr std::uint32_t s_Ambiguous = UINT32_MAX;
+
+	public:
+		PdbSymbols();
+
+		/**
+		 * @brief Maps the PDB and indexes its public symbols and section contributions.
+		 *
+		 * @return true If the file is an MSF 7.0 PDB with a DBI stream
+		 */
+		bool Load(const std::filesystem::path& file);
+		/**
+		 * @brief Whether the PDB was written for this build of the module, the GUID and age of its CodeView record.
+		 */
+		bool Matches(const ModuleIdentity& identity) const;
+
+		/**
+		 * @return std::optional<std::uint32_t> RVA of the symbol, std::nullopt if it is unknown or ambiguous
+		 */
+		std::optional<std::uint32_t> Find(std::string_view name) const;
+		/**
+		 * @brief The section contribution, a piece of one compiland, that holds the RVA.
+		 */
+		const Contribution* FindContribution(std::uint32_t rva) const;
+
+		std::size_t Size() const
+		{
+			return m_Symbols.size();
+		}
+
+	private:
+		bool ReadDirectory();
+		/**
+		 * @brief Stream contents, a view into the mapping where the blocks are adjacent and a copy where they are not.
+		 */
+		std::span<const std::uint8_t> Stream(std::size_t index);
+		std::span<const std::uint8_t> Block(std::uint32_t index) const;
+
+		void ReadSectionHeaders(std::span<const std::uint8_t> dbi);
+		void ReadContributions(std::span<const std::uint8_t> contributions);
+		void ReadPublics(std::span<const std::uint8_t> publics, std::span<const std::uint8_t> records);
+		void AddSymbol(std::string_view name, std::uint32_t rva);
+	};
+}
@@ -0,0 +1,112 @@
+#include "PebModuleProvider.hpp"
+
+#include <winternl.h>
+
+namespace NewBase
+{
+	using LdrDllNotificationFunc           = void(CALLBACK*)(ULONG reason, const void* data, void* context);
+	using LdrRegisterDllNotificationFunc   = NTSTATUS(NTAPI*)(ULONG flags, LdrDllNotificationFunc callback, void* context, void** cookie);
+	using LdrUnregisterDllNotificationFunc = NTSTATUS(NTAPI*)(void* cookie);
+	using LdrLockLoaderLockFunc            = NTSTATUS(NTAPI*)(ULONG flags, ULONG* disposition, void** cookie);
+	using LdrUnlockLoaderLockFunc          = NTSTATUS(NTAPI*)(ULONG flags, void* cookie);
+
+	/**
+	 * @brief Holds the loader lock for its lifetime, loads and unloads that would free list entries wait until it is gone.
+	 * The lock is reentrant, taking it from DllMain or a loader notification is fine.
+	 */
+	class LoaderLock
+	{
+	private:
+		void* m_Cookie;
+
+	public:
+		LoaderLock() :
+		    m_Cookie(nullptr)
+		{
+			static const auto lock = reinterpret_cast<LdrLockLoaderLockFunc>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrLockLoaderLock"));
+			if (lock && lock(0, nullptr, &m_Cookie) != 0) // STATUS_SUCCESS
+				m_Cookie = nullptr;
+		}
+
+		~LoaderLock()
+		{
+			static const auto unlock = reinterpret_cast<LdrUnlockLoaderLockFunc>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrUnlockLoaderLock"));
+			if (m_Cookie && unlock)
+				unlock(0, m_Cookie);
+		}
+
+		LoaderLock(const LoaderLock&)                = delete;
+		LoaderLock(LoaderLock&&) noexcept            = delete;
+		LoaderLock& operator=(const LoaderLock&)     = delete;
+		LoaderLock& operator=(LoaderLock&&) noexcept = delete;
+
+		bool Held() const
+		{
+			return m_Cookie != nullptr;
+		}
+	};
+
+	PebModuleProvider::PebModuleProvider() :
+	    m_OnChange(),
+	    m_Cookie(nullptr)
+	{
+	}
+
+	PebModuleProvider::~PebModuleProvider()
+	{
+		if (!m_Cookie)
+			return;
+
+		if (const auto unregister = reinterpret_cast<LdrUnregisterDllNotificationFunc>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrUnregisterDllNotification")))
+			unregister(m_Cookie);
+	}
+
+	std::vector<LoadedModule> PebModuleProvider::Modules() const
+	{
+		const auto peb = reinterpret_cast<PPEB>(NtCurrentTeb()->ProcessEnvironmentBlock);
+		if (!peb)
+			return {};
+
+		const auto ldrData = peb->Ldr;
+		if (!ldrData)
+			return {};
+
+		// lookups refresh from any thread, a module loading or unloading meanwhile would free the entries being walked
+		const LoaderLock lock;
+		if (!lock.Held())
+			return {};
+
+		std::vector<LoadedModule> modules;
+
+		const auto moduleList = &ldrData->InMemoryOrderModuleList;
+		auto moduleEntry      = moduleList->Flink;
+		for (; moduleList != moduleEntry; moduleEntry = moduleEntry->Flink)
+		{
+			const auto tableEntry = CONTAINING_RECORD(moduleEntry, LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
+			if (!tableEntry)
+				continue;
+
+			if (tableEntry->FullDllName.Buffer)
+				modules.push_back({tableEntry->FullDllName.Buffer, reinterpret_cast<std::uintptr_t>(tableEntry->DllBase)});
+		}
+
+		return modules;
+	}
+
+	bool PebModuleProvider::Watch(std::function<void()> onChange)
+	{
+		// not part of the SDK, ntdll exports it since Vista
+		const auto registerNotification = reinterpret_cast<LdrRegisterDllNotificationFunc>(GetProcAddress(GetModuleHandleA("ntdll.dll"), "LdrRegisterDllNotification"));
+		if (!registerNotification || m_Cookie)
+			return false;
+
+		m_OnChange = std::move(onChange);
+		return registerNotification(0, &PebModuleProvider::OnNotification, this, &m_Cookie) == 0; // STATUS_SUCCESS
+	}
+
+	void CALLBACK PebModuleProvider::OnNotification(ULONG, const void*, void* context)
+	{
+		// runs under the loader lock, only mark the snapshot stale and leave the work to the next lookup
+		static_cast<PebModuleProvider*>(context)->m_OnChange();
+	}
+}
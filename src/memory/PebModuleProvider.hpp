@@ -0,0 +1,25 @@
+#pragma once
+#include "ModuleProvider.hpp"
+
+namespace NewBase
+{
+	/**
+	 * @brief Reads the loader list of the PEB and registers for loader notifications through ntdll.
+	 */
+	class PebModuleProvider final : public IModuleProvider
+	{
+	private:
+		std::function<void()> m_OnChange;
+		void* m_Cookie;
+
+	public:
+		PebModuleProvider();
+		virtual ~PebModuleProvider();
+
+		virtual std::vector<LoadedModule> Modules() const override;
+		virtual bool Watch(std::function<void()> onChange) override;
+
+	private:
+		static void CALLBACK OnNotification(ULONG reason, const void* data, void* context);
+	};
+}
@@ -0,0 +1,88 @@
+#include "PoolRegistry.hpp"
+
+#include "util/Joaat.hpp"
+
+#include <utility>
+
+namespace NewBase
+{
+	const PoolInfo& PoolRegistry::AddImpl(const PoolHeader* pool, const char* name)
+	{
+		// a size request that built something other than this pool, a spatial array for one, must not name it
+		const auto pending = std::exchange(s_PendingSize, {});
+		const auto sized   = pending.m_Hash && pending.m_Size == pool->m_Size;
+		auto hash          = sized ? pending.m_Hash : 0;
+		if (!sized && name)
+			hash = Joaat(name);
+
+		std::lock_guard lock(m_WriteMutex);
+
+		auto table       = m_Table.load(std::memory_order_relaxed);
+		const auto known = FindImpl(pool) != nullptr;
+
+		// a pool built where another one was has been torn down at least once, it may well be again
+		const auto& info = m_Records.emplace_back(PoolInfo{pool, &m_Counters.emplace_back(), hash, pool->m_Size, pool->m_ItemSize, sized && !known});
+
+		if (!table || (!known && (m_Count.load(std::memory_order_relaxed) + 1) * 2 > table->m_Mask + 1))
+			table = Grow(table ? 64 - table->m_Shift + 1 : s_InitialBits);
+
+		Insert(*table, &info);
+		if (!known)
+			m_Count.fetch_add(1, std::memory_order_relaxed);
+
+		LOG(VERBOSE) << "Pool " << HEX(hash) << " at " << HEX(reinterpret_cast<std::uintptr_t>(pool)) << " holds " << info.m_Capacity
+		             << " items of " << info.m_ItemSize << " bytes.";
+		return info;
+	}
+
+	std::vector<const PoolInfo*> PoolRegistry::PoolsImpl()
+	{
+		std::lock_guard lock(m_WriteMutex);
+
+		std::vector<const PoolInfo*> pools;
+		if (const auto table = m_Table.load(std::memory_order_relaxed))
+		{
+			pools.reserve(m_Count.load(std::memory_order_relaxed));
+			for (std::size_t i = 0; i <= table->m_Mask; i++)
+			{
+				if (const auto info = table->m_Slots[i].load(std::memory_order_relaxed))
+					pools.push_back(info);
+			}
+		}
+		return pools;
+	}
+
+	const PoolRegistry::Table* PoolRegistry::Grow(int bits)
+	{
+		auto table     = std::make_unique<Table>();
+		table->m_Slots = std::make_unique<std::atomic<const PoolInfo*>[]>(std::size_t(1) << bits);
+		table->m_Mask  = (std::size_t(1) << bits) - 1;
+		table->m_Shift = 64 - bits;
+
+		// the newest record of every pool goes in, older ones were replaced and are only reachable through old tables
+		if (const auto previous = m_Table.load(std::memory_order_relaxed))
+		{
+			for (std::size_t i = 0; i <= previous->m_Mask; i++)
+			{
+				if (const auto info = previous->m_Slots[i].load(std::memory_order_relaxed))
+					Insert(*table, info);
+			}
+		}
+
+		m_Table.store(table.get(), std::memory_order_release);
+		return m_Tables.emplace_back(std::move(table)).get();
+	}
+
+	void PoolRegistry::Insert(const Table& table, const PoolInfo* info)
+	{
+		for (auto slot = Home(table, info->m_Pool);; slot = (slot + 1) & table.m_Mask)
+		{
+			const auto current = table.m_Slots[slot].load(std::memory_order_relaxed);
+			if (!current || current->m_Pool == info->m_Pool)
+			{
+				table.m_Slots[slot].store(info, std::memory_order_release);
+				return;
+			}
+		}
+	}
+}
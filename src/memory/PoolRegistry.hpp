@@ -0,0 +1,205 @@
+#pragma once
+#include "common.hpp"
+
+#include <deque>
+#include <mutex>
+
+namespace NewBase
+{
+	using joaat_t = std::uint32_t;
+
+	/**
+	 * @brief Leading fields of rage::fwBasePool, the same for every pool the game creates.
+	 */
+	struct PoolHeader
+	{
+		std::uint8_t* m_Items;
+		std::uint8_t* m_Flags; // one byte per item, the high bit is set while the item is free
+		std::uint32_t m_Size;
+		std::uint32_t m_ItemSize;
+	};
+
+	/**
+	 * @brief Allocation counters of one pool, split into cache line sized shards so threads allocating at once never share a line.
+	 *
+	 * The first threads to count get a shard of their own and bump it without a locked instruction, every thread after them
+	 * shares the last shard. Shards are never handed back, readers sum all of them.
+	 */
+	struct PoolCounters
+	{
+		static constexpr std::size_t s_Shards = 16;
+
+		struct alignas(64) Shard
+		{
+			std::atomic<std::uint64_t> m_Allocations = 0;
+			std::atomic<std::uint64_t> m_Failures    = 0;
+		};
+		std::array<Shard, s_Shards> m_Shards;
+
+		void Count(bool allocated)
+		{
+			const auto index = ThreadShard();
+			auto& counter    = allocated ? m_Shards[index].m_Allocations : m_Shards[index].m_Failures;
+			if (index < s_Shards - 1)
+				counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			else
+				counter.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::uint64_t Allocations() const
+		{
+			return Sum(&Shard::m_Allocations);
+		}
+
+		std::uint64_t Failures() const
+		{
+			return Sum(&Shard::m_Failures);
+		}
+
+	private:
+		static inline thread_local std::size_t s_ThreadShard = s_Shards; // s_Shards until the thread counted once
+		static inline std::atomic<std::size_t> s_NextShard   = 0;
+
+		static std::size_t ThreadShard()
+		{
+			if (s_ThreadShard == s_Shards)
+				s_ThreadShard = std::min<std::size_t>(s_NextShard.fetch_add(1, std::memory_order_relaxed), s_Shards - 1);
+			return s_ThreadShard;
+		}
+
+		std::uint64_t Sum(std::atomic<std::uint64_t> Shard::*counter) const
+		{
+			std::uint64_t sum = 0;
+			for (const auto& shard : m_Shards)
+				sum += (shard.*counter).load(std::memory_order_relaxed);
+			return sum;
+		}
+	};
+
+	/**
+	 * @brief Everything known about one pool in a single record, a lookup touches one cache line past the table.
+	 */
+	struct PoolInfo
+	{
+		const void* m_Pool;
+		PoolCounters* m_Counters; // the only part of a record that changes after it was published
+		joaat_t m_Hash;           // name hash the game sized the pool by, zero if it is unknown
+		std::uint32_t m_Capacity;
+		std::uint32_t m_ItemSize;
+		bool m_Permanent; // sized through the game config and the first pool at its address, the game keeps these until it exits
+	};
+
+	/**
+	 * @brief The pools the game created, written a few hundred times during boot and read from any allocating thread.
+	 *
+	 * Pool addresses index an open addressing table of pointers to immutable records. Readers probe it without locks,
+	 * writers take a mutex, publish every record with a single store and publish a bigger table once the current one is
+	 * half full. Neither records nor tables are ever freed, readers never announce when they are done with them.
+	 */
+	class PoolRegistry
+	{
+	public:
+		PoolRegistry()                                   = default;
+		virtual ~PoolRegistry()                          = default;
+		PoolRegistry(const PoolRegistry&)                = delete;
+		PoolRegistry(PoolRegistry&&) noexcept            = delete;
+		PoolRegistry& operator=(const PoolRegistry&)     = delete;
+		PoolRegistry& operator=(PoolRegistry&&) noexcept = delete;
+
+		/**
+		 * @brief Remembers the size the game was just given for a config entry.
+		 * The next pool this thread creates takes the hash if it has exactly that size, not every entry sizes a pool.
+		 */
+		static void SetPendingSize(joaat_t hash, std::uint32_t size)
+		{
+			s_PendingSize = {hash, size};
+		}
+
+		/**
+		 * @brief Records a pool the game finished constructing, replacing whatever was known about its address.
+		 * The name hash comes from the last size request of the same thread if the pool has that size, otherwise from the name.
+		 */
+		static const PoolInfo& Add(const PoolHeader* pool, const char* name)
+		{
+			return GetInstance().AddImpl(pool, name);
+		}
+
+		/**
+		 * @return const PoolInfo* nullptr if the pool is unknown, otherwise valid for the lifetime of the process
+		 */
+		static const PoolInfo* Find(const void* pool)
+		{
+			return GetInstance().FindImpl(pool);
+		}
+
+		static std::size_t Size()
+		{
+			return GetInstance().m_Count.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief The newest record of every known pool, in no particular order.
+		 */
+		static std::vector<const PoolInfo*> Pools()
+		{
+			return GetInstance().PoolsImpl();
+		}
+
+	private:
+		struct PendingSize
+		{
+			joaat_t m_Hash;
+			std::uint32_t m_Size;
+		};
+
+		struct Table
+		{
+			std::unique_ptr<std::atomic<const PoolInfo*>[]> m_Slots; // nullptr ends a probe
+			std::size_t m_Mask;
+			int m_Shift;
+		};
+
+		std::atomic<const Table*> m_Table = nullptr;
+		std::atomic<std::size_t> m_Count  = 0;
+		std::mutex m_WriteMutex;
+		std::deque<PoolInfo> m_Records;
+		std::deque<PoolCounters> m_Counters;
+		std::vector<std::unique_ptr<const Table>> m_Tables;
+
+		static constexpr int s_InitialBits = 9;
+		static inline thread_local PendingSize s_PendingSize = {};
+
+		static PoolRegistry& GetInstance()
+		{
+			static PoolRegistry i{};
+			return i;
+		}
+
+		/**
+		 * @brief Fibonacci hashing, pools are aligned heap objects whose low bits alone would crowd a few slots.
+		 */
+		static std::size_t Home(const Table& table, const void* pool)
+		{
+			return static_cast<std::size_t>((static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pool)) * 0x9E3779B97F4A7C15ull) >> table.m_Shift);
+		}
+
+		const PoolInfo* FindImpl(const void* pool) const
+		{
+			const auto table = m_Table.load(std::memory_order_acquire);
+			if (!table)
+				return nullptr;
+
+			for (auto slot = Home(*table, pool);; slot = (slot + 1) & table->m_Mask)
+			{
+				const auto info = table->m_Slots[slot].load(std::memory_order_acquire);
+				if (!info || info->m_Pool == pool)
+					return info;
+			}
+		}
+
+		const PoolInfo& AddImpl(const PoolHeader* pool, const char* name);
+		std::vector<const PoolInfo*> PoolsImpl();
+		const Table* Grow(int bits);
+		static void Insert(const Table& table, const PoolInfo* info);
+	};
+}
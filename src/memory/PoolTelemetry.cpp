@@ -0,0 +1,130 @@
+#include "PoolTelemetry.hpp"
+
+#include "PoolRegistry.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace NewBase
+{
+	void PoolTelemetry::InitImpl(const std::filesystem::path& file, std::chrono::milliseconds interval)
+	{
+		if (m_Thread.joinable())
+			return;
+
+		m_File     = file;
+		m_Interval = interval;
+		m_Start    = std::chrono::steady_clock::now();
+		m_Thread   = std::jthread([this](std::stop_token stop) {
+			Run(stop);
+		});
+	}
+
+	void PoolTelemetry::DestroyImpl()
+	{
+		if (!m_Thread.joinable())
+			return;
+
+		// at process exit the thread was already terminated, the join returns at once
+		m_Thread.request_stop();
+		m_Thread.join();
+	}
+
+	void PoolTelemetry::Run(std::stop_token stop)
+	{
+		std::mutex mutex;
+		std::unique_lock lock(mutex);
+
+		// wakes up early only to stop, the last snapshot is still written
+		bool stopping = false;
+		while (!stopping)
+		{
+			stopping = m_Wake.wait_for(lock, stop, m_Interval, [&stop] {
+				return stop.stop_requested();
+			});
+
+			Write(Collect());
+		}
+	}
+
+	std::vector<PoolTelemetry::Sample> PoolTelemetry::Collect()
+	{
+		const auto pools = PoolRegistry::Pools();
+
+		std::vector<Sample> samples;
+		samples.reserve(pools.size());
+		for (const auto info : pools)
+		{
+			auto& sample         = samples.emplace_back();
+			sample.m_Info        = info;
+			sample.m_Used        = info->m_Permanent ? CountUsed(*info) : 0;
+			sample.m_Failures    = info->m_Counters->Failures();
+			sample.m_Allocations = info->m_Counters->Allocations();
+
+			auto& highWater    = m_HighWater[info];
+			highWater          = std::max<std::uint32_t>({highWater, sample.m_Used, sample.m_Failures ? info->m_Capacity : 0});
+			sample.m_HighWater = highWater;
+		}
+
+		// the pools closest to their limit come first, empty pools have no limit to be close to and go last
+		std::ranges::sort(samples, [](const Sample& a, const Sample& b) {
+			const auto emptyA = a.m_Info->m_Capacity == 0;
+			const auto emptyB = b.m_Info->m_Capacity == 0;
+			if (emptyA != emptyB)
+				return emptyB;
+
+			const auto fillA = std::uint64_t(a.m_HighWater) * (emptyB ? 1 : b.m_Info->m_Capacity);
+			const auto fillB = std::uint64_t(b.m_HighWater) * (emptyA ? 1 : a.m_Info->m_Capacity);
+			if (fillA != fillB)
+				return fillA > fillB;
+			return a.m_Info->m_Hash < b.m_Info->m_Hash;
+		});
+		return samples;
+	}
+
+	void PoolTelemetry::Write(const std::vector<Sample>& samples) const
+	{
+		auto temporary = m_File;
+		temporary += ".tmp";
+
+		{
+			std::ofstream file(temporary, std::ios::trunc);
+			if (!file)
+			{
+				LOG(WARNING) << "Could not write pool telemetry to " << temporary.string();
+				return;
+			}
+
+			const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - m_Start);
+			file << "# " << uptime.count() << "s, " << samples.size() << " pools\n";
+			file << "pool,capacity,item_size,used,high_water,allocations,failures\n";
+			for (const auto& sample : samples)
+			{
+				file << "0x" << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << sample.m_Info->m_Hash << std::dec << ','
+				     << sample.m_Info->m_Capacity << ',' << sample.m_Info->m_ItemSize << ',';
+				// pools that may be torn down are never read, only their counters are known
+				if (sample.m_Info->m_Permanent)
+					file << sample.m_Used << ',' << sample.m_HighWater;
+				else
+					file << ',';
+				file << ',' << sample.m_Allocations << ',' << sample.m_Failures << '\n';
+			}
+		}
+
+		// readers only ever see a complete snapshot
+		std::error_code error;
+		std::filesystem::rename(temporary, m_File, error);
+		if (error)
+			LOG(WARNING) << "Could not replace " << m_File.string() << ": " << error.message();
+	}
+
+	std::uint32_t PoolTelemetry::CountUsed(const PoolInfo& info)
+	{
+		// only called for permanent pools, the game flips these bytes while they are read and a sample only has to be about right
+		const auto pool    = static_cast<const PoolHeader*>(info.m_Pool);
+		std::uint32_t used = 0;
+		for (std::uint32_t i = 0; i < info.m_Capacity; i++)
+			used += !(std::atomic_ref(pool->m_Flags[i]).load(std::memory_order_relaxed) & 0x80);
+		return used;
+	}
+}
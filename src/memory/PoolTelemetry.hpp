@@ -0,0 +1,79 @@
+#pragma once
+#include "common.hpp"
+
+#include <condition_variable>
+#include <stop_token>
+#include <unordered_map>
+
+namespace NewBase
+{
+	struct PoolInfo;
+
+	/**
+	 * @brief Periodically writes how full every known pool is to a small CSV file, rewritten in place on every sample.
+	 *
+	 * Occupancy is counted from the free bits in the pool's flags on a background thread, the allocating threads only bump
+	 * the counters of their shard. The high-water mark is the fullest a sample ever saw a pool, a pool that failed an
+	 * allocation has been full at least once. Nothing tells the registry when a pool is torn down, so only permanent pools
+	 * are read, the rest are reported by their counters alone.
+	 */
+	class PoolTelemetry
+	{
+	private:
+		PoolTelemetry() = default;
+
+	public:
+		virtual ~PoolTelemetry()                           = default;
+		PoolTelemetry(const PoolTelemetry&)                = delete;
+		PoolTelemetry(PoolTelemetry&&) noexcept            = delete;
+		PoolTelemetry& operator=(const PoolTelemetry&)     = delete;
+		PoolTelemetry& operator=(PoolTelemetry&&) noexcept = delete;
+
+		/**
+		 * @brief Starts the sampler, calling it again while it runs does nothing.
+		 */
+		static void Init(const std::filesystem::path& file, std::chrono::milliseconds interval = std::chrono::seconds(2))
+		{
+			GetInstance().InitImpl(file, interval);
+		}
+
+		/**
+		 * @brief Stops the sampler, a running one writes one last snapshot first.
+		 * Must not be called under the loader lock while the sampler still runs, its thread cannot exit until the lock is released.
+		 */
+		static void Destroy()
+		{
+			GetInstance().DestroyImpl();
+		}
+
+	private:
+		struct Sample
+		{
+			const PoolInfo* m_Info;
+			std::uint32_t m_Used;
+			std::uint32_t m_HighWater;
+			std::uint64_t m_Allocations;
+			std::uint64_t m_Failures;
+		};
+
+		std::filesystem::path m_File;
+		std::chrono::milliseconds m_Interval;
+		std::chrono::steady_clock::time_point m_Start;
+		std::unordered_map<const PoolInfo*, std::uint32_t> m_HighWater; // only touched by the sampler thread
+		std::condition_variable_any m_Wake;
+		std::jthread m_Thread;
+
+		static PoolTelemetry& GetInstance()
+		{
+			static PoolTelemetry i{};
+			return i;
+		}
+
+		void InitImpl(const std::filesystem::path& file, std::chrono::milliseconds interval);
+		void DestroyImpl();
+		void Run(std::stop_token stop);
+		std::vector<Sample> Collect();
+		void Write(const std::vector<Sample>& samples) const;
+		static std::uint32_t CountUsed(const PoolInfo& info);
+	};
+}
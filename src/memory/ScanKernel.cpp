@@ -0,0 +1,131 @@
+#include "ScanKernel.hpp"
+
+#include <bit>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define SCAN_KERNEL_X64
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define SCAN_KERNEL_AVX2
+	#else
+		#define SCAN_KERNEL_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace NewBase
+{
+	static const std::uint8_t* FindScalar(const std::uint8_t* begin, const std::uint8_t* last, const ScanSignature& signature)
+	{
+		const auto anchor       = signature.m_Anchor;
+		const auto secondAnchor = signature.m_SecondAnchor;
+		const auto first        = signature.m_Values[anchor];
+		const auto second       = signature.m_Values[secondAnchor];
+
+		if (const auto skipTable = signature.m_SkipTable)
+		{
+			const auto tail = signature.Size() - 1;
+			for (auto i = begin; i <= last; i += skipTable[i[tail]])
+			{
+				if (i[anchor] == first && ScanKernel::Matches(i, signature))
+					return i;
+
+				if (last - i < skipTable[i[tail]])
+					break;
+			}
+			return nullptr;
+		}
+
+		for (auto i = begin; i <= last; ++i)
+		{
+			if (i[anchor] == first && i[secondAnchor] == second && ScanKernel::Matches(i, signature))
+				return i;
+		}
+		return nullptr;
+	}
+
+#ifdef SCAN_KERNEL_X64
+	static const std::uint8_t* FindSSE2(const std::uint8_t* begin, const std::uint8_t* last, const ScanSignature& signature)
+	{
+		const auto anchor       = signature.m_Anchor;
+		const auto secondAnchor = signature.m_SecondAnchor;
+		const auto first        = _mm_set1_epi8(static_cast<char>(signature.m_Values[anchor]));
+		const auto second       = _mm_set1_epi8(static_cast<char>(signature.m_Values[secondAnchor]));
+
+		auto i = begin;
+		for (; last - i >= 31; i += 32)
+		{
+			const auto lo = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(i + anchor)), first),
+			    _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(i + secondAnchor)), second));
+			const auto hi = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(i + anchor + 16)), first),
+			    _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(i + secondAnchor + 16)), second));
+
+			auto candidates = static_cast<std::uint32_t>(_mm_movemask_epi8(lo)) | static_cast<std::uint32_t>(_mm_movemask_epi8(hi)) << 16;
+			while (candidates)
+			{
+				const auto candidate = i + std::countr_zero(candidates);
+				if (ScanKernel::Matches(candidate, signature))
+					return candidate;
+
+				candidates &= candidates - 1;
+			}
+		}
+		return FindScalar(i, last, signature);
+	}
+
+	SCAN_KERNEL_AVX2 static const std::uint8_t* FindAVX2(const std::uint8_t* begin, const std::uint8_t* last, const ScanSignature& signature)
+	{
+		const auto anchor       = signature.m_Anchor;
+		const auto secondAnchor = signature.m_SecondAnchor;
+		const auto first        = _mm256_set1_epi8(static_cast<char>(signature.m_Values[anchor]));
+		const auto second       = _mm256_set1_epi8(static_cast<char>(signature.m_Values[secondAnchor]));
+
+		auto i = begin;
+		for (; last - i >= 63; i += 64)
+		{
+			const auto lo = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + anchor)), first),
+			    _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + secondAnchor)), second));
+			const auto hi = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + anchor + 32)), first),
+			    _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + secondAnchor + 32)), second));
+
+			auto candidates = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(lo)))
+			    | static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(hi))) << 32;
+			while (candidates)
+			{
+				const auto candidate = i + std::countr_zero(candidates);
+				if (ScanKernel::Matches(candidate, signature))
+					return candidate;
+
+				candidates &= candidates - 1;
+			}
+		}
+		_mm256_zeroupper();
+		return FindSSE2(i, last, signature);
+	}
+#endif
+
+	const std::uint8_t* ScanKernel::Find(const std::uint8_t* begin, const std::uint8_t* end, const ScanSignature& signature)
+	{
+		return Find(begin, end, signature, Detect());
+	}
+
+	const std::uint8_t* ScanKernel::Find(const std::uint8_t* begin, const std::uint8_t* end, const ScanSignature& signature, Level level)
+	{
+		if (!signature.Size() || end < begin || static_cast<std::size_t>(end - begin) < signature.Size())
+			return nullptr;
+
+		// a signature without a single fixed byte matches anywhere
+		if (!signature.m_HasAnchor)
+			return begin;
+
+		const auto last = end - signature.Size();
+		switch (level)
+		{
+#ifdef SCAN_KERNEL_X64
+		case Level::AVX2: return FindAVX2(begin, last, signature);
+		case Level::SSE2: return FindSSE2(begin, last, signature);
+#endif
+		default: return FindScalar(begin, last, signature);
+		}
+	}
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include "util/CpuLevel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace NewBase
+{
+	/**
+	 * @brief Flattened signature as consumed by the scan kernels.
+	 * Every mask byte is either 0xFF (fixed) or 0x00 (wildcard) and every value byte is already masked.
+	 */
+	struct ScanSignature
+	{
+		std::span<const std::uint8_t> m_Values;
+		std::span<const std::uint8_t> m_Masks;
+		const std::uint8_t* m_SkipTable; // optional 256 entry Boyer-Moore-Horspool shifts
+		std::size_t m_Anchor;
+		std::size_t m_SecondAnchor;
+		std::size_t m_Pair; // offset of the rarest two adjacent fixed bytes, Size() if there are none
+		bool m_HasAnchor;
+
+		constexpr std::size_t Size() const
+		{
+			return m_Values.size();
+		}
+	};
+
+	class ScanKernel
+	{
+	public:
+		using Level = CpuLevel;
+
+		/**
+		 * @brief Best kernel the running CPU supports, detected once.
+		 */
+		static Level Detect()
+		{
+			return DetectCpuLevel();
+		}
+
+		/**
+		 * @brief Finds the first match of the signature which lies entirely inside [begin, end).
+		 *
+		 * @return const std::uint8_t* Start of the match or nullptr
+		 */
+		static const std::uint8_t* Find(const std::uint8_t* begin, const std::uint8_t* end, const ScanSignature& signature);
+		static const std::uint8_t* Find(const std::uint8_t* begin, const std::uint8_t* end, const ScanSignature& signature, Level level);
+
+		/**
+		 * @brief Rough likelihood of a byte showing up in x86-64 code, lower is rarer.
+		 */
+		static constexpr std::uint8_t ByteWeight(std::uint8_t byte);
+
+		/**
+		 * @brief Picks the two rarest fixed bytes and the rarest adjacent fixed pair of a signature as its anchors.
+		 */
+		static constexpr void SelectAnchors(ScanSignature& signature);
+		/**
+		 * @brief Fills a wildcard-aware Horspool table, a wildcard matches every byte and caps the shift accordingly.
+		 */
+		static constexpr void BuildSkipTable(const ScanSignature& signature, std::span<std::uint8_t, 256> table);
+
+		static inline bool Matches(const std::uint8_t* data, const ScanSignature& signature);
+	};
+
+	inline constexpr std::uint8_t ScanKernel::ByteWeight(std::uint8_t byte)
+	{
+		switch (byte)
+		{
+		case 0x00:
+		case 0xFF:
+		case 0x48:
+		case 0x8B:
+		case 0x89:
+		case 0xCC: return 255;
+		case 0x01:
+		case 0x0F:
+		case 0x24:
+		case 0x33:
+		case 0x41:
+		case 0x44:
+		case 0x45:
+		case 0x49:
+		case 0x4C:
+		case 0x83:
+		case 0x85:
+		case 0x8D:
+		case 0xC0:
+		case 0xE8: return 192;
+		case 0x02:
+		case 0x03:
+		case 0x04:
+		case 0x05:
+		case 0x08:
+		case 0x0D:
+		case 0x10:
+		case 0x18:
+		case 0x20:
+		case 0x28:
+		case 0x30:
+		case 0x38:
+		case 0x40:
+		case 0x4D:
+		case 0x50:
+		case 0x5C:
+		case 0x74:
+		case 0x75:
+		case 0x80:
+		case 0x84:
+		case 0x90:
+		case 0xC1:
+		case 0xC3:
+		case 0xC7:
+		case 0xE9:
+		case 0xEB:
+		case 0xF8: return 128;
+		default: return 32;
+		}
+	}
+
+	inline constexpr void ScanKernel::SelectAnchors(ScanSignature& signature)
+	{
+		signature.m_Anchor       = 0;
+		signature.m_SecondAnchor = 0;
+		signature.m_Pair         = signature.Size();
+		signature.m_HasAnchor    = false;
+
+		unsigned int pairWeight = ~0u;
+		for (std::size_t i = 0; i < signature.Size(); ++i)
+		{
+			if (!signature.m_Masks[i])
+				continue;
+
+			if (i + 1 < signature.Size() && signature.m_Masks[i + 1])
+			{
+				if (const unsigned int weight = ByteWeight(signature.m_Values[i]) + ByteWeight(signature.m_Values[i + 1]); weight < pairWeight)
+				{
+					signature.m_Pair = i;
+					pairWeight       = weight;
+				}
+			}
+
+			if (!signature.m_HasAnchor)
+			{
+				signature.m_Anchor       = i;
+				signature.m_SecondAnchor = i;
+				signature.m_HasAnchor    = true;
+				continue;
+			}
+
+			const auto weight = ByteWeight(signature.m_Values[i]);
+			if (weight < ByteWeight(signature.m_Values[signature.m_Anchor]))
+			{
+				signature.m_SecondAnchor = signature.m_Anchor;
+				signature.m_Anchor       = i;
+			}
+			else if (signature.m_SecondAnchor == signature.m_Anchor || weight < ByteWeight(signature.m_Values[signature.m_SecondAnchor]))
+			{
+				signature.m_SecondAnchor = i;
+			}
+		}
+	}
+
+	inline constexpr void ScanKernel::BuildSkipTable(const ScanSignature& signature, std::span<std::uint8_t, 256> table)
+	{
+		const auto size = signature.Size();
+
+		std::size_t shift = size;
+		for (std::size_t i = 0; i + 1 < size; ++i)
+		{
+			if (!signature.m_Masks[i])
+				shift = size - 1 - i;
+		}
+
+		for (auto& entry : table)
+			entry = static_cast<std::uint8_t>(shift < 0xFF ? shift : 0xFF);
+
+		for (std::size_t i = 0; i + 1 < size; ++i)
+		{
+			if (signature.m_Masks[i] && size - 1 - i < table[signature.m_Values[i]])
+				table[signature.m_Values[i]] = static_cast<std::uint8_t>(size - 1 - i);
+		}
+	}
+
+	inline bool ScanKernel::Matches(const std::uint8_t* data, const ScanSignature& signature)
+	{
+		const auto size   = signature.Size();
+		const auto values = signature.m_Values.data();
+		const auto masks  = signature.m_Masks.data();
+
+		std::size_t i = 0;
+		for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+		{
+			std::uint64_t word, mask, value;
+			std::memcpy(&word, data + i, sizeof(word));
+			std::memcpy(&mask, masks + i, sizeof(mask));
+			std::memcpy(&value, values + i, sizeof(value));
+			if ((word & mask) != value)
+				return false;
+		}
+		for (; i < size; ++i)
+		{
+			if ((data[i] & masks[i]) != values[i])
+				return false;
+		}
+		return true;
+	}
+}
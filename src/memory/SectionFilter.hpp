@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace NewBase
+{
+	struct ModuleSection
+	{
+		std::string m_Name;
+		std::uint32_t m_Rva;
+		std::uint32_t m_Size;
+		std::uint32_t m_Characteristics;
+	};
+
+	/**
+	 * @brief Selects which sections of a module a signature may be found in.
+	 */
+	struct SectionFilter
+	{
+		std::uint32_t m_Characteristics; // every one of these IMAGE_SCN_* bits has to be set
+		std::string_view m_Name;         // empty matches any section name
+
+		constexpr bool Matches(const ModuleSection& section) const
+		{
+			return (section.m_Characteristics & m_Characteristics) == m_Characteristics && (m_Name.empty() || section.m_Name == m_Name);
+		}
+
+		/**
+		 * @brief Sections mapped as executable, where every code signature lives.
+		 */
+		static constexpr SectionFilter Executable()
+		{
+			return {0x20000000 /* IMAGE_SCN_MEM_EXECUTE */, {}};
+		}
+
+		static constexpr SectionFilter Named(const std::string_view name)
+		{
+			return {0, name};
+		}
+
+		static constexpr SectionFilter Any()
+		{
+			return {0, {}};
+		}
+	};
+}
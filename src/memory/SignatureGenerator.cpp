@@ -0,0 +1,198 @@
+#include "SignatureGenerator.hpp"
+
+#include "InstructionDecoder.hpp"
+#include "SuffixIndex.hpp"
+#include "XrefIndex.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace NewBase
+{
+	std::string GeneratedSignature::Literal(std::string_view name) const
+	{
+		std::ostringstream literal;
+		literal << "Pattern<\"" << m_Pattern << "\">(\"" << name << "\")";
+		return literal.str();
+	}
+
+	SignatureGenerator::SignatureGenerator(const Module& module, const SuffixIndex& index, const XrefIndex* xrefs) :
+	    m_Module(module),
+	    m_Index(index),
+	    m_Xrefs(xrefs),
+	    m_MaxLength(64)
+	{
+	}
+
+	void SignatureGenerator::SetMaxLength(std::size_t length)
+	{
+		m_MaxLength = length;
+	}
+
+	std::optional<GeneratedSignature> SignatureGenerator::Generate(std::uintptr_t target) const
+	{
+		std::optional<GeneratedSignature> best;
+		const auto consider = [&best](const Candidate& candidate, std::string resolve) {
+			const auto length = candidate.m_Values.size();
+			if (best && best->m_Length <= length)
+				return;
+
+			best = GeneratedSignature{Format(candidate), std::move(resolve), candidate.m_Start, length};
+		};
+
+		const auto rva     = target - m_Module.Base();
+		const auto section = std::ranges::find_if(m_Module.Sections(), [rva](const ModuleSection& section) {
+			return rva >= section.m_Rva && rva - section.m_Rva < section.m_Size;
+		});
+		if (target < m_Module.Base() || section == m_Module.Sections().end())
+			return std::nullopt;
+
+		if (SectionFilter::Executable().Matches(*section))
+		{
+			for (const auto start : InstructionStarts(target))
+			{
+				const auto candidate = Grow(start);
+				if (!candidate)
+					continue;
+
+				std::ostringstream resolve;
+				if (target != start)
+					resolve << ".Add(" << target - start << ")";
+				consider(*candidate, resolve.str());
+			}
+		}
+
+		if (!m_Xrefs)
+			return best;
+
+		// walk back from every instruction that encodes the target as rel32 or disp32
+		std::vector<Xref> references;
+		for (const auto& xref : m_Xrefs->CallersOf(target))
+			references.push_back(xref);
+		for (const auto& xref : m_Xrefs->ReferencesTo(target))
+			references.push_back(xref);
+		if (references.size() > s_MaxReferences)
+			references.resize(s_MaxReferences);
+
+		for (const auto& xref : references)
+		{
+			const auto source  = m_Xrefs->Address(xref.m_Source);
+			const auto decoded = InstructionDecoder::Decode({reinterpret_cast<const std::uint8_t*>(source), std::min<std::size_t>(15, m_Module.End() - source)});
+			if (!decoded || !decoded->HasRelative())
+				continue;
+
+			for (const auto start : InstructionStarts(source))
+			{
+				const auto candidate = Grow(start);
+				if (!candidate)
+					continue;
+
+				std::ostringstream resolve;
+				resolve << ".Add(" << source - start + decoded->m_RelativeOffset << ").Rip()";
+				if (decoded->RelativeTrailing())
+					resolve << ".Add(" << static_cast<int>(decoded->RelativeTrailing()) << ")";
+				consider(*candidate, resolve.str());
+			}
+		}
+		return best;
+	}
+
+	std::vector<std::uintptr_t> SignatureGenerator::InstructionStarts(std::uintptr_t address) const
+	{
+		const auto rva       = static_cast<std::uint32_t>(address - m_Module.Base());
+		const auto functions = m_Module.RuntimeFunctions();
+
+		const auto function = std::ranges::upper_bound(functions, rva, {}, &RUNTIME_FUNCTION::BeginAddress);
+		if (function == functions.begin() || rva >= std::prev(function)->EndAddress)
+			return {address};
+
+		// x86 cannot be decoded backwards, decode forward from the start of the function instead
+		const auto code = reinterpret_cast<const std::uint8_t*>(m_Module.Base());
+		const auto end  = std::prev(function)->EndAddress;
+
+		std::vector<std::uintptr_t> starts;
+		for (auto position = std::prev(function)->BeginAddress; position <= rva;)
+		{
+			if (position + s_MaxBacktrack >= rva)
+				starts.push_back(m_Module.Base() + position);
+
+			const auto decoded = InstructionDecoder::Decode({code + position, end - position});
+			if (!decoded)
+				break;
+			position += decoded->m_Length;
+		}
+		if (starts.empty())
+			return {address};
+
+		std::ranges::reverse(starts);
+		return starts;
+	}
+
+	std::optional<SignatureGenerator::Candidate> SignatureGenerator::Grow(std::uintptr_t start) const
+	{
+		const auto rva     = start - m_Module.Base();
+		const auto section = std::ranges::find_if(m_Module.Sections(), [rva](const ModuleSection& section) {
+			return rva >= section.m_Rva && rva - section.m_Rva < section.m_Size;
+		});
+		if (section == m_Module.Sections().end())
+			return std::nullopt;
+
+		const auto code = reinterpret_cast<const std::uint8_t*>(start);
+		const auto end  = reinterpret_cast<const std::uint8_t*>(m_Module.Base() + section->m_Rva + section->m_Size);
+
+		Candidate candidate{{}, {}, start};
+		const auto unique = [this, &candidate](std::size_t length) {
+			const ScanSignature signature{{candidate.m_Values.data(), length}, {candidate.m_Masks.data(), length}, nullptr, 0, 0, length, false};
+			return m_Index.Count(signature, 2) == 1;
+		};
+
+		while (candidate.m_Values.size() < m_MaxLength)
+		{
+			const auto position = code + candidate.m_Values.size();
+			const auto decoded  = InstructionDecoder::Decode({position, static_cast<std::size_t>(end - position)});
+			if (!decoded)
+				return std::nullopt;
+
+			const auto previous = candidate.m_Values.size();
+			for (std::size_t i = 0; i < decoded->m_Length; ++i)
+			{
+				const auto relative = decoded->HasRelative() && i >= decoded->m_RelativeOffset && i < decoded->m_RelativeOffset + 4u;
+				candidate.m_Values.push_back(relative ? 0 : position[i]);
+				candidate.m_Masks.push_back(relative ? 0 : 0xFF);
+			}
+
+			if (!unique(candidate.m_Values.size()))
+				continue;
+
+			// the last instruction made it unique, part of it may already be enough
+			auto length = candidate.m_Values.size();
+			while (length > previous + 1 && unique(length - 1))
+				length--;
+			while (!candidate.m_Masks[length - 1])
+				length--;
+
+			candidate.m_Values.resize(length);
+			candidate.m_Masks.resize(length);
+			return candidate;
+		}
+		return std::nullopt;
+	}
+
+	std::string SignatureGenerator::Format(const Candidate& candidate)
+	{
+		std::ostringstream pattern;
+		pattern << std::hex << std::uppercase << std::setfill('0');
+		for (std::size_t i = 0; i < candidate.m_Values.size(); ++i)
+		{
+			if (i)
+				pattern << ' ';
+
+			if (candidate.m_Masks[i])
+				pattern << std::setw(2) << static_cast<int>(candidate.m_Values[i]);
+			else
+				pattern << '?';
+		}
+		return pattern.str();
+	}
+}
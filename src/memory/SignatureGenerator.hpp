@@ -0,0 +1,75 @@
+#pragma once
+#include "Module.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NewBase
+{
+	class SuffixIndex;
+	class XrefIndex;
+
+	struct GeneratedSignature
+	{
+		std::string m_Pattern;   // bytes in the notation Pattern<S> takes, "?" for wildcards
+		std::string m_Resolve;   // PointerCalculator calls turning the match into the target, empty if the match is the target
+		std::uintptr_t m_Match;  // where the signature matches
+		std::size_t m_Length;    // bytes up to the last fixed one
+
+		/**
+		 * @brief The signature the way Signatures.hpp declares one.
+		 */
+		std::string Literal(std::string_view name) const;
+	};
+
+	/**
+	 * @brief Writes the shortest signature that matches exactly once in the executable sections of a module and leads back to an address.
+	 *
+	 * Signatures start on instruction boundaries near the target, or near an instruction referring to it when an XrefIndex is given,
+	 * and grow one instruction at a time until the suffix index reports a single match. Rel32 branches and RIP relative operands are
+	 * wildcarded since they change whenever code or data moves between builds.
+	 */
+	class SignatureGenerator
+	{
+	private:
+		struct Candidate
+		{
+			std::vector<std::uint8_t> m_Values;
+			std::vector<std::uint8_t> m_Masks;
+			std::uintptr_t m_Start;
+		};
+
+		const Module& m_Module;
+		const SuffixIndex& m_Index;
+		const XrefIndex* m_Xrefs;
+		std::size_t m_MaxLength;
+
+		static constexpr std::size_t s_MaxBacktrack  = 64; // farthest a signature may start in front of the instruction it leads back from
+		static constexpr std::size_t s_MaxReferences = 32;
+
+	public:
+		SignatureGenerator(const Module& module, const SuffixIndex& index, const XrefIndex* xrefs = nullptr);
+
+		/**
+		 * @brief Longest signature worth trying from a single start, defaults to 64 bytes.
+		 */
+		void SetMaxLength(std::size_t length);
+
+		/**
+		 * @brief Signature for a code address directly, or for any address through the instructions referring to it.
+		 *
+		 * @return std::nullopt If no start within reach grows into a unique signature
+		 */
+		std::optional<GeneratedSignature> Generate(std::uintptr_t target) const;
+
+	private:
+		/**
+		 * @brief Instruction boundaries at or in front of address within the backtrack distance, nearest first.
+		 */
+		std::vector<std::uintptr_t> InstructionStarts(std::uintptr_t address) const;
+		std::optional<Candidate> Grow(std::uintptr_t start) const;
+		static std::string Format(const Candidate& candidate);
+	};
+}
@@ -0,0 +1,415 @@
+#include "SuffixIndex.hpp"
+
+#include "filemgr/FileMgr.hpp"
+#include "util/WorkerPool.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+namespace NewBase
+{
+	static constexpr std::uint32_t s_Empty = UINT32_MAX;
+
+	/**
+	 * @brief SA-IS by Nong, Zhang and Chan, sorts all suffixes in linear time by inducing them from the sorted LMS substrings.
+	 *
+	 * @param text Every symbol lies in [0, upper]
+	 */
+	template<typename Symbol>
+	static std::vector<std::uint32_t> SuffixSort(std::span<const Symbol> text, std::uint32_t upper)
+	{
+		const auto n = static_cast<std::uint32_t>(text.size());
+		if (n == 0)
+			return {};
+		if (n == 1)
+			return {0};
+		if (n == 2)
+			return text[0] < text[1] ? std::vector<std::uint32_t>{0, 1} : std::vector<std::uint32_t>{1, 0};
+
+		// S type suffixes are smaller than the one following them, the last suffix counts as L type
+		std::vector<bool> small(n);
+		for (auto i = n - 1; i-- > 0;)
+			small[i] = text[i] == text[i + 1] ? small[i + 1] : text[i] < text[i + 1];
+
+		// bucket of every symbol, L type suffixes fill it from the front and S type suffixes from the back
+		std::vector<std::uint32_t> startL(upper + 1), startS(upper + 1);
+		for (std::uint32_t i = 0; i < n; ++i)
+		{
+			if (!small[i])
+				startS[text[i]]++;
+			else
+				startL[text[i] + 1]++;
+		}
+		for (std::uint32_t i = 0; i <= upper; ++i)
+		{
+			startS[i] += startL[i];
+			if (i < upper)
+				startL[i + 1] += startS[i];
+		}
+
+		std::vector<std::uint32_t> sa(n);
+		std::vector<std::uint32_t> bucket(upper + 1);
+		const auto induce = [&](const std::vector<std::uint32_t>& lms) {
+			std::ranges::fill(sa, s_Empty);
+
+			std::ranges::copy(startS, bucket.begin());
+			for (const auto position : lms)
+				sa[bucket[text[position]]++] = position;
+
+			std::ranges::copy(startL, bucket.begin());
+			sa[bucket[text[n - 1]]++] = n - 1;
+			for (std::uint32_t i = 0; i < n; ++i)
+			{
+				const auto position = sa[i];
+				if (position != s_Empty && position >= 1 && !small[position - 1])
+					sa[bucket[text[position - 1]]++] = position - 1;
+			}
+
+			std::ranges::copy(startL, bucket.begin());
+			for (auto i = n; i-- > 0;)
+			{
+				const auto position = sa[i];
+				if (position != s_Empty && position >= 1 && small[position - 1])
+					sa[--bucket[text[position - 1] + 1]] = position - 1;
+			}
+		};
+
+		std::vector<std::uint32_t> lmsIndex(n + 1, s_Empty);
+		std::vector<std::uint32_t> lms;
+		for (std::uint32_t i = 1; i < n; ++i)
+		{
+			if (!small[i - 1] && small[i])
+			{
+				lmsIndex[i] = static_cast<std::uint32_t>(lms.size());
+				lms.push_back(i);
+			}
+		}
+
+		induce(lms);
+		if (lms.empty())
+			return sa;
+
+		// name the LMS substrings in their sorted order and sort the reduced string of names recursively
+		const auto m = static_cast<std::uint32_t>(lms.size());
+
+		std::vector<std::uint32_t> sorted;
+		sorted.reserve(m);
+		for (const auto position : sa)
+		{
+			if (lmsIndex[position] != s_Empty)
+				sorted.push_back(position);
+		}
+
+		std::vector<std::uint32_t> reduced(m);
+		std::uint32_t names = 0;
+		reduced[lmsIndex[sorted[0]]] = 0;
+		for (std::uint32_t i = 1; i < m; ++i)
+		{
+			auto left       = sorted[i - 1];
+			auto right      = sorted[i];
+			const auto endL = lmsIndex[left] + 1 < m ? lms[lmsIndex[left] + 1] : n;
+			const auto endR = lmsIndex[right] + 1 < m ? lms[lmsIndex[right] + 1] : n;
+
+			bool same = endL - left == endR - right;
+			if (same)
+			{
+				while (left < endL && text[left] == text[right])
+				{
+					left++;
+					right++;
+				}
+				same = left != n && text[left] == text[right];
+			}
+			if (!same)
+				names++;
+			reduced[lmsIndex[sorted[i]]] = names;
+		}
+		lmsIndex = {};
+
+		const auto reducedSa = SuffixSort<std::uint32_t>(reduced, names);
+		for (std::uint32_t i = 0; i < m; ++i)
+			sorted[i] = lms[reducedSa[i]];
+
+		induce(sorted);
+		return sa;
+	}
+
+	/**
+	 * @brief Offset and length of the longest run of fixed bytes, the length is 0 for a signature made of wildcards.
+	 */
+	static std::pair<std::size_t, std::size_t> LongestFixedRun(const ScanSignature& signature)
+	{
+		std::size_t bestOffset = 0, bestLength = 0;
+		for (std::size_t i = 0; i < signature.Size();)
+		{
+			if (!signature.m_Masks[i])
+			{
+				++i;
+				continue;
+			}
+
+			const auto begin = i;
+			while (i < signature.Size() && signature.m_Masks[i])
+				++i;
+
+			if (i - begin > bestLength)
+			{
+				bestOffset = begin;
+				bestLength = i - begin;
+			}
+		}
+		return {bestOffset, bestLength};
+	}
+
+	SuffixIndex::SuffixIndex() :
+	    m_Base(0),
+	    m_Identity(),
+	    m_Sections(),
+	    m_Parts()
+	{
+	}
+
+	void SuffixIndex::Build(const Module& module, std::size_t threads)
+	{
+		m_Base     = module.Base();
+		m_Identity = module.Identity();
+		m_Sections = module.Sections();
+		m_Parts.clear();
+
+		if (!module.Valid())
+			return;
+
+		for (const auto& section : m_Sections)
+		{
+			if (SectionFilter::Executable().Matches(section) && section.m_Size)
+				m_Parts.push_back({section, {}});
+		}
+
+		// SA-IS itself is sequential, the sections are independent though
+		WorkerPool pool(threads ? threads - 1 : WorkerPool::DefaultThreads());
+		for (auto& part : m_Parts)
+		{
+			pool.Push([this, &part] {
+				const auto text = reinterpret_cast<const std::uint8_t*>(m_Base + part.m_Section.m_Rva);
+				part.m_Suffixes = SuffixSort(std::span(text, part.m_Section.m_Size), UINT8_MAX);
+			});
+		}
+		pool.Wait();
+	}
+
+	bool SuffixIndex::Load(const std::filesystem::path& file, const Module& module)
+	{
+		std::ifstream stream(file, std::ios::binary);
+		if (!stream)
+			return false;
+
+		const auto read = [&stream](auto& value) {
+			return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+		};
+
+		const auto identity = module.Identity();
+
+		std::uint32_t magic, version, count;
+		ModuleIdentity saved;
+		if (!read(magic) || !read(version) || magic != s_Magic || version != s_Version)
+		{
+			LOG(WARNING) << "Ignoring suffix index with unknown format: " << file.string();
+			return false;
+		}
+		if (!read(saved.m_TimeDateStamp) || !read(saved.m_SizeOfImage) || !read(saved.m_Guid) || !read(saved.m_Age) || saved != identity)
+			return false;
+		if (!read(count))
+			return false;
+
+		std::vector<Part> parts;
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			std::uint32_t rva, size;
+			if (!read(rva) || !read(size))
+				return false;
+
+			const auto section = std::ranges::find_if(module.Sections(), [rva, size](const ModuleSection& section) {
+				return section.m_Rva == rva && section.m_Size == size;
+			});
+			if (section == module.Sections().end())
+				return false;
+
+			auto& part = parts.emplace_back(*section, std::vector<std::uint32_t>(size));
+			if (!stream.read(reinterpret_cast<char*>(part.m_Suffixes.data()), static_cast<std::streamsize>(size) * sizeof(std::uint32_t)))
+				return false;
+
+			// queries read the image at these offsets, a damaged file must not send them outside the section
+			if (std::ranges::any_of(part.m_Suffixes, [size](std::uint32_t offset) {
+				    return offset >= size;
+			    }))
+			{
+				LOG(WARNING) << "Suffix index is damaged: " << file.string();
+				return false;
+			}
+		}
+
+		m_Base     = module.Base();
+		m_Identity = identity;
+		m_Sections = module.Sections();
+		m_Parts    = std::move(parts);
+		return true;
+	}
+
+	bool SuffixIndex::Save(const std::filesystem::path& file) const
+	{
+		std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			LOG(WARNING) << "Failed to write suffix index: " << file.string();
+			return false;
+		}
+
+		const auto write = [&stream](const auto& value) {
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+
+		write(s_Magic);
+		write(s_Version);
+		write(m_Identity.m_TimeDateStamp);
+		write(m_Identity.m_SizeOfImage);
+		write(m_Identity.m_Guid);
+		write(m_Identity.m_Age);
+		write(static_cast<std::uint32_t>(m_Parts.size()));
+		for (const auto& part : m_Parts)
+		{
+			write(part.m_Section.m_Rva);
+			write(part.m_Section.m_Size);
+			stream.write(reinterpret_cast<const char*>(part.m_Suffixes.data()), static_cast<std::streamsize>(part.m_Suffixes.size()) * sizeof(std::uint32_t));
+		}
+		return static_cast<bool>(stream);
+	}
+
+	void SuffixIndex::LoadOrBuild(const Module& module, std::size_t threads)
+	{
+		if (!module.Valid())
+			return;
+
+		const auto file = FileMgr::GetProjectFile(std::filesystem::path("./cache") / (std::string(module.Name()) + ".sa"));
+		if (Load(file.Path(), module))
+		{
+			LOG(INFO) << "Loaded the suffix index of " << module.Name() << " from disk.";
+			return;
+		}
+
+		Build(module, threads);
+		Save(file.Path());
+	}
+
+	template<typename F>
+	bool SuffixIndex::ForEachMatch(const Part& part, const ScanSignature& signature, F&& func) const
+	{
+		const auto text = reinterpret_cast<const std::uint8_t*>(m_Base + part.m_Section.m_Rva);
+		const auto size = part.m_Section.m_Size;
+		if (signature.Size() > size)
+			return true;
+
+		const auto [offset, length] = LongestFixedRun(signature);
+		if (!length)
+		{
+			// nothing to search for, every position matches
+			for (std::size_t i = 0; i + signature.Size() <= size; ++i)
+			{
+				if (!func(text + i))
+					return false;
+			}
+			return true;
+		}
+
+		const auto run = signature.m_Values.data() + offset;
+
+		// a suffix shorter than the run that equals its beginning sorts before it
+		const auto compare = [text, size, run, length](std::uint32_t suffix) {
+			const auto available = size - suffix;
+			if (const auto result = std::memcmp(text + suffix, run, std::min<std::size_t>(available, length)))
+				return result;
+			return available < length ? -1 : 0;
+		};
+
+		const auto first = std::ranges::partition_point(part.m_Suffixes, [&compare](std::uint32_t suffix) {
+			return compare(suffix) < 0;
+		});
+		const auto last = std::ranges::partition_point(first, part.m_Suffixes.end(), [&compare](std::uint32_t suffix) {
+			return compare(suffix) == 0;
+		});
+
+		for (auto it = first; it != last; ++it)
+		{
+			if (*it < offset || *it - offset + signature.Size() > size)
+				continue;
+
+			const auto candidate = text + (*it - offset);
+			if (ScanKernel::Matches(candidate, signature) && !func(candidate))
+				return false;
+		}
+		return true;
+	}
+
+	const std::uint8_t* SuffixIndex::FindFirst(const ScanSignature& signature, const SectionFilter& filter) const
+	{
+		for (const auto& part : m_Parts)
+		{
+			if (!filter.Matches(part.m_Section))
+				continue;
+
+			// parts are ordered by RVA, the first part with a match holds the lowest one
+			const std::uint8_t* first = nullptr;
+			ForEachMatch(part, signature, [&first](const std::uint8_t* match) {
+				if (!first || match < first)
+					first = match;
+				return true;
+			});
+			if (first)
+				return first;
+		}
+		return nullptr;
+	}
+
+	std::vector<const std::uint8_t*> SuffixIndex::FindAll(const ScanSignature& signature, const SectionFilter& filter) const
+	{
+		std::vector<const std::uint8_t*> matches;
+		for (const auto& part : m_Parts)
+		{
+			if (!filter.Matches(part.m_Section))
+				continue;
+
+			const auto begin = matches.size();
+			ForEachMatch(part, signature, [&matches](const std::uint8_t* match) {
+				matches.push_back(match);
+				return true;
+			});
+			std::sort(matches.begin() + begin, matches.end());
+		}
+		return matches;
+	}
+
+	std::size_t SuffixIndex::Count(const ScanSignature& signature, std::size_t limit, const SectionFilter& filter) const
+	{
+		std::size_t count = 0;
+		for (const auto& part : m_Parts)
+		{
+			if (count >= limit)
+				break;
+			if (!filter.Matches(part.m_Section))
+				continue;
+
+			ForEachMatch(part, signature, [&count, limit](const std::uint8_t*) {
+				return ++count < limit;
+			});
+		}
+		return count;
+	}
+
+	bool SuffixIndex::Covers(const SectionFilter& filter) const
+	{
+		return std::ranges::all_of(m_Sections, [this, &filter](const ModuleSection& section) {
+			return !filter.Matches(section) || !section.m_Size || std::ranges::any_of(m_Parts, [&section](const Part& part) {
+				return part.m_Section.m_Rva == section.m_Rva;
+			});
+		});
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Module.hpp"
+#include "Pattern.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace NewBase
+{
+	/**
+	 * @brief Suffix array over the executable sections of a module, answers pattern queries without scanning the image.
+	 *
+	 * A query binary searches the longest run of fixed bytes in the signature and verifies the full mask at every
+	 * occurrence of that run, which takes microseconds for any signature specific enough to be useful. Building takes
+	 * seconds and four bytes per indexed byte, so the index is meant for large signature sets and tooling that queries
+	 * one build over and over, and it can be saved to disk next to the offset cache.
+	 */
+	class SuffixIndex
+	{
+	private:
+		struct Part
+		{
+			ModuleSection m_Section;
+			std::vector<std::uint32_t> m_Suffixes; // section offsets ordered by the suffix starting there
+		};
+
+		std::uintptr_t m_Base;
+		ModuleIdentity m_Identity;
+		std::vector<ModuleSection> m_Sections;
+		std::vector<Part> m_Parts;
+
+		static constexpr std::uint32_t s_Magic   = 0x58415359; // "YSAX"
+		static constexpr std::uint32_t s_Version = 1;
+
+	public:
+		SuffixIndex();
+
+		/**
+		 * @brief Sorts the suffixes of every executable section, sections are sorted in parallel.
+		 *
+		 * @param threads Amount of threads to use including the calling one, 0 picks every hardware thread
+		 */
+		void Build(const Module& module, std::size_t threads = 0);
+		/**
+		 * @brief Reads an index saved for this exact build of the module.
+		 *
+		 * @return true If the file exists, belongs to the module identity and is intact
+		 */
+		bool Load(const std::filesystem::path& file, const Module& module);
+		bool Save(const std::filesystem::path& file) const;
+		/**
+		 * @brief Loads the index of this build from the cache folder under the FileMgr root, builds and saves it if there is none.
+		 */
+		void LoadOrBuild(const Module& module, std::size_t threads = 0);
+
+		/**
+		 * @brief Lowest match of the signature in the indexed sections the filter selects.
+		 *
+		 * @return const std::uint8_t* Start of the match or nullptr
+		 */
+		const std::uint8_t* FindFirst(const ScanSignature& signature, const SectionFilter& filter = SectionFilter::Executable()) const;
+		/**
+		 * @brief Every match of the signature in the indexed sections the filter selects, in ascending order.
+		 */
+		std::vector<const std::uint8_t*> FindAll(const ScanSignature& signature, const SectionFilter& filter = SectionFilter::Executable()) const;
+
+		/**
+		 * @brief Amount of matches in the indexed sections the filter selects, stops counting at the limit.
+		 */
+		std::size_t Count(const ScanSignature& signature, std::size_t limit = SIZE_MAX, const SectionFilter& filter = SectionFilter::Executable()) const;
+
+		const std::uint8_t* FindFirst(const IPattern& pattern) const
+		{
+			return FindFirst(pattern.Signature(), pattern.Filter() ? *pattern.Filter() : SectionFilter::Executable());
+		}
+
+		/**
+		 * @brief Whether every section of the module the filter selects is indexed, only then are query results complete.
+		 */
+		bool Covers(const SectionFilter& filter) const;
+		bool Empty() const
+		{
+			return m_Parts.empty();
+		}
+
+	private:
+		/**
+		 * @brief Calls func with every verified match inside one part in no particular order, until func returns false.
+		 *
+		 * @return false If func stopped the iteration
+		 */
+		template<typename F>
+		bool ForEachMatch(const Part& part, const ScanSignature& signature, F&& func) const;
+	};
+}
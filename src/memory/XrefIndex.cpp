@@ -0,0 +1,260 @@
+#include "XrefIndex.hpp"
+
+#include "Module.hpp"
+#include "util/WorkerPool.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace NewBase
+{
+	struct SectionRange
+	{
+		std::uint32_t m_Begin;
+		std::uint32_t m_End;
+	};
+
+	struct DecodeChunk
+	{
+		std::uint32_t m_Begin;
+		std::uint32_t m_End;
+		SectionRange m_Section;
+		std::vector<Xref> m_Branches;
+		std::vector<Xref> m_References;
+	};
+
+	static constexpr bool OrderByTarget(const Xref& a, const Xref& b)
+	{
+		return a.m_Target != b.m_Target ? a.m_Target < b.m_Target : a.m_Source < b.m_Source;
+	}
+
+	static bool InRanges(const std::vector<SectionRange>& ranges, std::int64_t rva)
+	{
+		const auto it = std::upper_bound(ranges.begin(), ranges.end(), rva, [](std::int64_t value, const SectionRange& range) {
+			return value < range.m_Begin;
+		});
+		return it != ranges.begin() && rva < std::prev(it)->m_End;
+	}
+
+	/**
+	 * @brief Bytes that can start one of the decoded instructions: E8, E9, 8B, 8D, 89 and every REX prefix.
+	 */
+	static constexpr std::array<bool, 256> s_LeadBytes = [] {
+		std::array<bool, 256> table{};
+		for (const auto byte : {0xE8, 0xE9, 0x8B, 0x8D, 0x89})
+			table[byte] = true;
+		for (int byte = 0x40; byte <= 0x4F; ++byte)
+			table[byte] = true;
+		return table;
+	}();
+
+	static void Decode(const std::uint8_t* base, std::uint32_t imageSize, const std::vector<SectionRange>& executable, DecodeChunk& chunk)
+	{
+		for (auto rva = chunk.m_Begin; rva < chunk.m_End; ++rva)
+		{
+			const auto code = base + rva;
+			if (!s_LeadBytes[code[0]])
+				continue;
+
+			const auto available = chunk.m_Section.m_End - rva;
+
+			if ((code[0] == 0xE8 || code[0] == 0xE9) && available >= 5)
+			{
+				std::int32_t displacement;
+				std::memcpy(&displacement, code + 1, sizeof(displacement));
+
+				if (const auto target = static_cast<std::int64_t>(rva) + 5 + displacement; InRanges(executable, target))
+				{
+					const auto kind = code[0] == 0xE8 ? XrefKind::Call : XrefKind::Jump;
+					chunk.m_Branches.push_back({static_cast<std::uint32_t>(target), rva, kind});
+				}
+			}
+
+			// [REX] 8B/8D/89 with mod 00 and rm 101, a REX byte right before means the instruction was already recorded from there
+			const std::uint32_t prefix = (code[0] & 0xF0) == 0x40;
+			if (!prefix && rva > chunk.m_Section.m_Begin && (code[-1] & 0xF0) == 0x40)
+				continue;
+			if (available < prefix + 6 || (code[prefix + 1] & 0xC7) != 0x05)
+				continue;
+
+			XrefKind kind;
+			switch (code[prefix])
+			{
+			case 0x8D: kind = XrefKind::Lea; break;
+			case 0x8B: kind = XrefKind::Load; break;
+			case 0x89: kind = XrefKind::Store; break;
+			default: continue;
+			}
+
+			std::int32_t displacement;
+			std::memcpy(&displacement, code + prefix + 2, sizeof(displacement));
+
+			if (const auto target = static_cast<std::int64_t>(rva) + prefix + 6 + displacement; target >= 0 && target < imageSize)
+				chunk.m_References.push_back({static_cast<std::uint32_t>(target), rva, kind});
+		}
+
+		std::ranges::sort(chunk.m_Branches, OrderByTarget);
+		std::ranges::sort(chunk.m_References, OrderByTarget);
+	}
+
+	/**
+	 * @brief Merges already sorted runs pairwise, every round of merges runs on the pool.
+	 */
+	static std::vector<Xref> MergeRuns(WorkerPool& pool, std::vector<std::vector<Xref>> runs)
+	{
+		if (runs.empty())
+			return {};
+
+		while (runs.size() > 1)
+		{
+			std::vector<std::vector<Xref>> merged((runs.size() + 1) / 2);
+			for (std::size_t i = 0; i < merged.size(); ++i)
+			{
+				pool.Push([&runs, &merged, i] {
+					if (2 * i + 1 == runs.size())
+					{
+						merged[i] = std::move(runs[2 * i]);
+						return;
+					}
+
+					const auto& a = runs[2 * i];
+					const auto& b = runs[2 * i + 1];
+					merged[i].resize(a.size() + b.size());
+					std::ranges::merge(a, b, merged[i].begin(), OrderByTarget);
+				});
+			}
+			pool.Wait();
+			runs = std::move(merged);
+		}
+		return std::move(runs.front());
+	}
+
+	XrefIndex::XrefIndex() :
+	    m_Base(0),
+	    m_Branches(),
+	    m_References(),
+	    m_Functions()
+	{
+	}
+
+	void XrefIndex::Build(const Module& module, std::size_t threads)
+	{
+		m_Base = module.Base();
+		m_Branches.clear();
+		m_References.clear();
+		m_Functions.clear();
+
+		if (!module.Valid())
+			return;
+
+		std::vector<SectionRange> executable;
+		std::vector<DecodeChunk> chunks;
+		for (const auto& section : module.Sections())
+		{
+			if (!SectionFilter::Executable().Matches(section))
+				continue;
+
+			const SectionRange range{section.m_Rva, section.m_Rva + section.m_Size};
+			executable.push_back(range);
+
+			for (auto begin = range.m_Begin; begin < range.m_End; begin += static_cast<std::uint32_t>(std::min<std::size_t>(s_ChunkSize, range.m_End - begin)))
+			{
+				const auto end = static_cast<std::uint32_t>(std::min<std::size_t>(begin + s_ChunkSize, range.m_End));
+				chunks.push_back({begin, end, range, {}, {}});
+			}
+		}
+
+		WorkerPool pool(threads ? threads - 1 : WorkerPool::DefaultThreads());
+
+		const auto base      = reinterpret_cast<const std::uint8_t*>(m_Base);
+		const auto imageSize = static_cast<std::uint32_t>(module.Size());
+		for (auto& chunk : chunks)
+		{
+			pool.Push([base, imageSize, &executable, &chunk] {
+				Decode(base, imageSize, executable, chunk);
+			});
+		}
+		pool.Wait();
+
+		std::vector<std::vector<Xref>> branches, references;
+		for (auto& chunk : chunks)
+		{
+			branches.push_back(std::move(chunk.m_Branches));
+			references.push_back(std::move(chunk.m_References));
+		}
+		m_Branches   = MergeRuns(pool, std::move(branches));
+		m_References = MergeRuns(pool, std::move(references));
+
+		LoadFunctions(module);
+	}
+
+	std::span<const Xref> XrefIndex::CallersOf(std::uintptr_t address) const
+	{
+		if (address < m_Base || address - m_Base > UINT32_MAX)
+			return {};
+
+		return EqualRange(m_Branches, static_cast<std::uint32_t>(address - m_Base));
+	}
+
+	std::span<const Xref> XrefIndex::ReferencesTo(std::uintptr_t address) const
+	{
+		if (address < m_Base || address - m_Base > UINT32_MAX)
+			return {};
+
+		return EqualRange(m_References, static_cast<std::uint32_t>(address - m_Base));
+	}
+
+	std::optional<std::uintptr_t> XrefIndex::FunctionContaining(std::uintptr_t address) const
+	{
+		if (address < m_Base || address - m_Base > UINT32_MAX)
+			return std::nullopt;
+
+		const auto rva = static_cast<std::uint32_t>(address - m_Base);
+		const auto it  = std::ranges::upper_bound(m_Functions, rva, {}, &FunctionRange::m_Begin);
+		if (it == m_Functions.begin() || rva >= std::prev(it)->m_End)
+			return std::nullopt;
+
+		return Address(std::prev(it)->m_Entry);
+	}
+
+	void XrefIndex::LoadFunctions(const Module& module)
+	{
+		constexpr std::uint8_t chainInfo = 4; // UNW_FLAG_CHAININFO
+		constexpr int maxChain           = 32;
+
+		const auto base = reinterpret_cast<const std::uint8_t*>(m_Base);
+		const auto size = module.Size();
+
+		const auto functions = module.RuntimeFunctions();
+		m_Functions.reserve(functions.size());
+		for (const auto& function : functions)
+		{
+			if (function.BeginAddress >= function.EndAddress || function.EndAddress > size)
+				continue;
+
+			// fragments split off by the compiler chain their unwind info to the function they belong to
+			auto primary = function;
+			for (int i = 0; i < maxChain && primary.UnwindInfoAddress + 4 <= size; ++i)
+			{
+				const auto unwind = base + primary.UnwindInfoAddress;
+				if (!(unwind[0] >> 3 & chainInfo))
+					break;
+
+				const auto chained = primary.UnwindInfoAddress + 4 + ((unwind[2] + 1) & ~1) * 2;
+				if (chained + sizeof(RUNTIME_FUNCTION) > size)
+					break;
+
+				std::memcpy(&primary, base + chained, sizeof(primary));
+			}
+
+			m_Functions.push_back({function.BeginAddress, function.EndAddress, primary.BeginAddress});
+		}
+		std::ranges::sort(m_Functions, {}, &FunctionRange::m_Begin);
+	}
+
+	std::span<const Xref> XrefIndex::EqualRange(const std::vector<Xref>& xrefs, std::uint32_t target)
+	{
+		const auto [first, last] = std::ranges::equal_range(xrefs, target, {}, &Xref::m_Target);
+		return {first, last};
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace NewBase
+{
+	class Module;
+
+	enum class XrefKind : std::uint8_t
+	{
+		Call,  // E8 rel32
+		Jump,  // E9 rel32
+		Lea,   // lea reg, [rip + disp32]
+		Load,  // mov reg, [rip + disp32]
+		Store, // mov [rip + disp32], reg
+	};
+
+	struct Xref
+	{
+		std::uint32_t m_Target; // RVA the instruction refers to
+		std::uint32_t m_Source; // RVA of the first byte of the instruction
+		XrefKind m_Kind;
+	};
+
+	/**
+	 * @brief Every rel32 branch and RIP relative lea/mov in the executable sections of a module, sorted by target.
+	 *
+	 * Code is decoded at every byte offset instead of following instructions, so the odd reference decoded from the middle
+	 * of another instruction makes it in as well. Branches have to land in an executable section and data references
+	 * inside the image, which keeps those rare enough for lookups of a known target.
+	 */
+	class XrefIndex
+	{
+	private:
+		struct FunctionRange
+		{
+			std::uint32_t m_Begin;
+			std::uint32_t m_End;
+			std::uint32_t m_Entry; // begin of the primary function when the range is a chained fragment of it
+		};
+
+		std::uintptr_t m_Base;
+		std::vector<Xref> m_Branches;
+		std::vector<Xref> m_References;
+		std::vector<FunctionRange> m_Functions;
+
+		static constexpr std::size_t s_ChunkSize = 1 << 20;
+
+	public:
+		XrefIndex();
+
+		/**
+		 * @brief Decodes the module once, splitting the executable sections over a worker pool.
+		 *
+		 * @param threads Amount of threads to use including the calling one, 0 picks every hardware thread
+		 */
+		void Build(const Module& module, std::size_t threads = 0);
+
+		/**
+		 * @brief Calls and jumps landing exactly on the address, ordered by source.
+		 */
+		std::span<const Xref> CallersOf(std::uintptr_t address) const;
+		/**
+		 * @brief RIP relative lea and mov instructions referring exactly to the address, ordered by source.
+		 */
+		std::span<const Xref> ReferencesTo(std::uintptr_t address) const;
+		/**
+		 * @brief Start of the function whose code contains the address, from the exception directory.
+		 */
+		std::optional<std::uintptr_t> FunctionContaining(std::uintptr_t address) const;
+
+		std::uintptr_t Address(std::uint32_t rva) const
+		{
+			return m_Base + rva;
+		}
+		std::size_t BranchCount() const
+		{
+			return m_Branches.size();
+		}
+		std::size_t ReferenceCount() const
+		{
+			return m_References.size();
+		}
+
+	private:
+		void LoadFunctions(const Module& module);
+		static std::span<const Xref> EqualRange(const std::vector<Xref>& xrefs, std::uint32_t target);
+	};
+}
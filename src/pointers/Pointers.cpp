@@ -3,58 +3,118 @@
 #include "memory/BytePatch.hpp"
 #include "memory/ModuleMgr.hpp"
 #include "memory/PatternScanner.hpp"
+#include "memory/PdbSymbols.hpp"
+#include "memory/ScanKernel.hpp"
+#include "pointers/Signatures.hpp"
 #include "util/Joaat.hpp"
 
 namespace NewBase
 {
-	bool Pointers::Init()
+	bool Pointers::Init(PointerReadyFunc onReady)
 	{
-		auto scanner = PatternScanner(ModuleMgr::Get("GTA5.exe"_J));
-
-		strcpy(ModuleMgr::Get("GTA5.exe"_J)->GetPdbFilePath(), (std::filesystem::current_path() / "GTA5.pdb").string().c_str());
+		m_OnReady = onReady;
+
+		const auto game = ModuleMgr::Get("GTA5.exe"_J);
+		auto scanner    = PatternScanner(game);
+		scanner.EnableCache();
+		scanner.SetStreaming(onReady != nullptr);
+#ifndef NDEBUG
+		scanner.SetUniqueCheck(true);
+#endif
+
+		const auto pdb = std::filesystem::current_path() / "GTA5.pdb";
+		// debuggers look for the PDB where the CodeView record says, the path is only rewritten where it fits in place
+		if (const auto pdbPath = game->GetPdbFilePath())
+		{
+			const auto path = pdb.string();
+			if (path.size() <= std::strlen(pdbPath))
+				std::memcpy(pdbPath, path.c_str(), path.size() + 1);
+			else
+				LOG(VERBOSE) << "Not pointing the CodeView record at " << path << ", it is longer than the original path.";
+		}
 
-		constexpr auto queueDependency = Pattern<"E8 ? ? ? ? B8 A0 00 00 00">("QueueDependency");
-		scanner.Add(queueDependency, [this](PointerCalculator ptr) {
-			m_QueueDependency = ptr.Add(1).Rip().As<PVOID>();
+		// a PDB written for this exact build names functions outright, only what it does not know is scanned for
+		PdbSymbols symbols;
+		const auto useSymbols = symbols.Load(pdb) && symbols.Matches(game->Identity());
+		if (useSymbols)
+			LOG(INFO) << "GTA5.pdb matches the game, resolving functions from its symbols.";
+
+		// a symbol only stands in for the scan if the pattern still matches the bytes it points at
+		const auto addFunction = [&](const IPattern& pattern, std::string_view symbol, PVOID PointerData::*pointer) {
+			if (const auto rva = useSymbols ? symbols.Find(symbol) : std::nullopt)
+			{
+				const auto& signature = pattern.Signature();
+				if (*rva + signature.Size() <= game->Size() && ScanKernel::Matches(reinterpret_cast<const std::uint8_t*>(game->Base() + *rva), signature))
+				{
+					this->*pointer = reinterpret_cast<PVOID>(game->Base() + *rva);
+					Ready(pointer);
+					return;
+				}
+				LOG(WARNING) << "Symbol " << symbol << " does not match [" << pattern.Name() << "], scanning for it instead.";
+			}
+
+			scanner.Add(pattern, [this, pointer](PointerCalculator ptr) {
+				this->*pointer = ptr.As<PVOID>();
+				Ready(pointer);
+			});
+		};
+
+		scanner.Add(Signatures::InitMemAllocator, [this](PointerCalculator ptr) {
+			*Signatures::ResolveInitMemAllocator(ptr).As<uint32_t*>() = 650 * 1024 * 1024;
 		});
 
-		constexpr auto initMemAllocator = Pattern<"83 C8 01 48 8D 0D ? ? ? ? 41 B1 01 45 33 C0">("InitMemAllocator");
-		scanner.Add(initMemAllocator, [this](PointerCalculator ptr) {
-			*ptr.Add(17).As<uint32_t*>() = 650 * 1024 * 1024;
+		scanner.Add(Signatures::SMPACreateStub, [this](PointerCalculator ptr) {
+			m_SMPACreateStub = Signatures::ResolveSMPACreateStub(ptr).As<PVOID>();
+			Ready(&PointerData::m_SMPACreateStub);
 		});
 
-		constexpr auto SMPACreateStub = Pattern<"49 63 F0 48 8B EA B9 07 00 00 00">("SMPACreateStub");
-		scanner.Add(SMPACreateStub, [this](PointerCalculator ptr) {
-			m_SMPACreateStub = ptr.Sub(0x29).As<PVOID>();
-		});
+		addFunction(Signatures::ReadGameConfig, "?Load@?$fwConfigManagerImpl@VCGameConfig@@@rage@@QEAAPEAV12@PEBD@Z", &PointerData::m_ReadGameConfig);
+		addFunction(Signatures::GetPoolSize, "?GetSizeOfPool@fwConfigManager@rage@@QEBAHIH@Z", &PointerData::m_GetPoolSize);
+		addFunction(Signatures::CreatePool, "??0fwBasePool@rage@@QEAA@HPEBDHH_N@Z", &PointerData::m_CreatePool);
 
-		constexpr auto readGameConfig = Pattern<"48 89 5C 24 10 55 56 57 41 54 41 55 41 56 41 57 48 8B EC 48 83 EC 30 48 8B F9">("ReadGameConfig");
-		scanner.Add(readGameConfig, [this](PointerCalculator ptr) {
-			m_ReadGameConfig = ptr.As<PVOID>();
-		});
+		if (!scanner.Scan())
+		{
+			LOG(FATAL) << "Some patterns could not be found, unloading.";
+			return false;
+		}
 
-		constexpr auto getPoolSize = Pattern<"45 33 DB 44 8B D2 66 44 39 59 10 74 4B">("GetPoolSize");
-		scanner.Add(getPoolSize, [this](PointerCalculator ptr) {
-			m_GetPoolSize = ptr.As<PVOID>();
-		});
+		InitLazy();
+
+		return true;
+	}
+
+	void Pointers::Ready(PVOID PointerData::*pointer) const
+	{
+		if (m_OnReady)
+			m_OnReady(pointer);
+	}
 
-		constexpr auto createPool = Pattern<"40 53 48 83 EC 20 8B 44 24 50 48 83">("CreatePool");
-		scanner.Add(createPool, [this](PointerCalculator ptr) {
-			m_CreatePool = ptr.As<PVOID>();
+	void Pointers::InitLazy()
+	{
+		// nothing before boot needs these, the game keeps loading while they are scanned for
+		auto scanner = std::make_shared<PatternScanner>(ModuleMgr::Get("GTA5.exe"_J));
+		scanner->EnableCache();
+#ifndef NDEBUG
+		scanner->SetUniqueCheck(true);
+#endif
+
+		scanner->Add(Signatures::QueueDependency, [this](PointerCalculator ptr) {
+			m_QueueDependency = Signatures::ResolveQueueDependency(ptr).As<PVOID>();
 		});
 
-		constexpr auto getPoolItem = Pattern<"4C 8B D1 48 63 49 18">("GetPoolItem");
-		scanner.Add(getPoolItem, [this](PointerCalculator ptr) {
+		scanner->Add(Signatures::GetPoolItem, [this](PointerCalculator ptr) {
 			m_GetPoolItem = ptr.As<PVOID>();
 		});
 
-		if (!scanner.Scan())
-		{
-			LOG(FATAL) << "Some patterns could not be found, unloading.";
-			return false;
-		}
+		const auto pending = std::async(std::launch::async, [scanner] {
+			if (!scanner->Scan())
+			{
+				LOG(WARNING) << "Some lazily resolved patterns could not be found.";
+			}
+		}).share();
 
-		return true;
+		m_QueueDependency.Defer(pending);
+		m_GetPoolItem.Defer(pending);
 	}
 
 	bool Pointers::InitScriptHook()
@@ -62,20 +122,21 @@ namespace NewBase
 		ModuleMgr::Refresh();
 
 		auto scanner = PatternScanner(ModuleMgr::Get("ScriptHookV.dll"_J));
+		scanner.EnableCache();
+#ifndef NDEBUG
+		scanner.SetUniqueCheck(true);
+#endif
 
-		constexpr auto onlineCheck = Pattern<"74 3A 48 8D 0D">("OnlineCheck");
-		scanner.Add(onlineCheck, [this](PointerCalculator ptr) {
+		scanner.Add(Signatures::OnlineCheck, [this](PointerCalculator ptr) {
 			BytePatch::Make(ptr.As<void*>(), std::to_array({0xEB}))->Apply();
 		});
 
-		constexpr auto poolStuff = Pattern<"41 81 FA 2C 23 82 11">("PoolStuff");
-		scanner.Add(poolStuff, [this](PointerCalculator ptr) {
+		scanner.Add(Signatures::PoolStuff, [this](PointerCalculator ptr) {
 			BytePatch::Make(ptr.As<void*>(), std::vector<uint8_t>(34, 0x90))->Apply();
 			BytePatch::Make(ptr.Add(34).As<void*>(), std::to_array({0xEB}))->Apply();
 		});
 
-		constexpr auto poolStuff2 = Pattern<"B8 00 01 00 00 3B C3">("PoolStuff2");
-		scanner.Add(poolStuff2, [this](PointerCalculator ptr) {
+		scanner.Add(Signatures::PoolStuff2, [this](PointerCalculator ptr) {
 			BytePatch::Make(ptr.As<void*>(), std::vector<uint8_t>(10, 0x90))->Apply();
 		});
 
@@ -1,23 +1,42 @@
 #pragma once
+#include "memory/LazyPointer.hpp"
+
 #include <d3d11.h>
 #include <windows.h>
 
 namespace NewBase
 {
+	/**
+	 * @brief Plain pointers are resolved before Init returns, LazyPointers by a background scan that the first read waits for.
+	 */
 	struct PointerData
 	{
-		PVOID m_QueueDependency;
+		LazyPointer<PVOID> m_QueueDependency;
 		PVOID m_SMPACreateStub;
 		PVOID m_ReadGameConfig;
 		PVOID m_GetPoolSize;
 		PVOID m_CreatePool;
-		PVOID m_GetPoolItem;
+		LazyPointer<PVOID> m_GetPoolItem;
 	};
 
+	/**
+	 * @brief Told about every pointer Init resolves the moment it is known, possibly from a scanning thread.
+	 */
+	using PointerReadyFunc = void (*)(PVOID PointerData::*pointer);
+
 	struct Pointers : PointerData
 	{
-		bool Init();
+		/**
+		 * @brief Resolves every pointer needed before boot, scanning streams its results into onReady when one is given.
+		 */
+		bool Init(PointerReadyFunc onReady = nullptr);
 		bool InitScriptHook();
+
+	private:
+		void InitLazy();
+		void Ready(PVOID PointerData::*pointer) const;
+
+		PointerReadyFunc m_OnReady = nullptr;
 	};
 
 	inline NewBase::Pointers Pointers;
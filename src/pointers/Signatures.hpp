@@ -0,0 +1,71 @@
+#pragma once
+#include "memory/Pattern.hpp"
+#include "memory/PointerCalculator.hpp"
+
+#include <array>
+
+namespace NewBase
+{
+	/**
+	 * @brief A pattern together with the arithmetic that turns its match into the address Pointers actually uses.
+	 * Kept free of any Windows dependency so the offline tools resolve exactly what the loader resolves.
+	 */
+	struct PointerSignature
+	{
+		const IPattern* m_Pattern;
+		PointerCalculator (*m_Resolve)(PointerCalculator match);
+	};
+
+	namespace Signatures
+	{
+		// GTA5.exe
+		inline constexpr auto QueueDependency  = Pattern<"E8 ? ? ? ? B8 A0 00 00 00">("QueueDependency");
+		inline constexpr auto InitMemAllocator = Pattern<"83 C8 01 48 8D 0D ? ? ? ? 41 B1 01 45 33 C0">("InitMemAllocator");
+		inline constexpr auto SMPACreateStub   = Pattern<"49 63 F0 48 8B EA B9 07 00 00 00">("SMPACreateStub");
+		inline constexpr auto ReadGameConfig   = Pattern<"48 89 5C 24 10 55 56 57 41 54 41 55 41 56 41 57 48 8B EC 48 83 EC 30 48 8B F9">("ReadGameConfig");
+		inline constexpr auto GetPoolSize      = Pattern<"45 33 DB 44 8B D2 66 44 39 59 10 74 4B">("GetPoolSize");
+		inline constexpr auto CreatePool       = Pattern<"40 53 48 83 EC 20 8B 44 24 50 48 83">("CreatePool");
+		inline constexpr auto GetPoolItem      = Pattern<"4C 8B D1 48 63 49 18">("GetPoolItem");
+
+		// ScriptHookV.dll
+		inline constexpr auto OnlineCheck = Pattern<"74 3A 48 8D 0D">("OnlineCheck");
+		inline constexpr auto PoolStuff   = Pattern<"41 81 FA 2C 23 82 11">("PoolStuff");
+		inline constexpr auto PoolStuff2  = Pattern<"B8 00 01 00 00 3B C3">("PoolStuff2");
+
+		inline PointerCalculator ResolveMatch(PointerCalculator match)
+		{
+			return match;
+		}
+		inline PointerCalculator ResolveQueueDependency(PointerCalculator match)
+		{
+			return match.Add(1).Rip();
+		}
+		/**
+		 * @brief The immediate holding the allocator size.
+		 */
+		inline PointerCalculator ResolveInitMemAllocator(PointerCalculator match)
+		{
+			return match.Add(17);
+		}
+		inline PointerCalculator ResolveSMPACreateStub(PointerCalculator match)
+		{
+			return match.Sub(0x29);
+		}
+
+		inline constexpr std::array<PointerSignature, 7> Game = {{
+		    {&QueueDependency, ResolveQueueDependency},
+		    {&InitMemAllocator, ResolveInitMemAllocator},
+		    {&SMPACreateStub, ResolveSMPACreateStub},
+		    {&ReadGameConfig, ResolveMatch},
+		    {&GetPoolSize, ResolveMatch},
+		    {&CreatePool, ResolveMatch},
+		    {&GetPoolItem, ResolveMatch},
+		}};
+
+		inline constexpr std::array<PointerSignature, 3> ScriptHook = {{
+		    {&OnlineCheck, ResolveMatch},
+		    {&PoolStuff, ResolveMatch},
+		    {&PoolStuff2, ResolveMatch},
+		}};
+	}
+}
@@ -0,0 +1,43 @@
+#include "CpuLevel.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define CPU_LEVEL_X64
+	#ifdef _MSC_VER
+		#include <immintrin.h>
+		#include <intrin.h>
+	#endif
+#endif
+
+namespace NewBase
+{
+	static CpuLevel DetectImpl()
+	{
+#ifdef CPU_LEVEL_X64
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return CpuLevel::SSE2;
+
+		__cpuid(info, 1);
+		constexpr int osxsave = 1 << 27, avx = 1 << 28;
+		if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 6) != 6)
+			return CpuLevel::SSE2;
+
+		__cpuidex(info, 7, 0);
+		return info[1] & (1 << 5) ? CpuLevel::AVX2 : CpuLevel::SSE2;
+	#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") ? CpuLevel::AVX2 : CpuLevel::SSE2;
+	#endif
+#else
+		return CpuLevel::Scalar;
+#endif
+	}
+
+	CpuLevel DetectCpuLevel()
+	{
+		static const auto level = DetectImpl();
+		return level;
+	}
+}
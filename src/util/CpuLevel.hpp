@@ -0,0 +1,19 @@
+#pragma once
+
+namespace NewBase
+{
+	/**
+	 * @brief Vector extensions a code path may use, ordered so a higher level implies the lower ones.
+	 */
+	enum class CpuLevel
+	{
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+	/**
+	 * @brief Best level the running CPU supports, detected once.
+	 */
+	CpuLevel DetectCpuLevel();
+}
@@ -1,19 +1,139 @@
 #include "Joaat.hpp"
 
+#if defined(_M_X64) || defined(__x86_64__)
+	#define JOAAT_X64
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#define JOAAT_AVX2
+	#else
+		#define JOAAT_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
 namespace NewBase
 {
-	constexpr joaat_t Joaat(const std::string_view str)
+	static void JoaatScalar(std::span<const std::string_view> strings, std::span<joaat_t> hashes)
+	{
+		for (std::size_t i = 0; i < strings.size(); ++i)
+			hashes[i] = Joaat(strings[i]);
+	}
+
+#ifdef JOAAT_X64
+	static constexpr std::size_t s_Lanes     = 8;
+	static constexpr std::size_t s_MaxLength = 256; // longer strings are hashed on their own, they would pad their whole group
+
+	JOAAT_AVX2 static inline __m256i Lowercase(__m256i bytes)
+	{
+		// signed compares, bytes above 0x7F are negative and never count as upper case
+		const auto upper = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes));
+		return _mm256_or_si256(bytes, _mm256_and_si256(upper, _mm256_set1_epi8(1 << 5)));
+	}
+
+	/**
+	 * @brief Four bytes of every lane, lowest first, each sign extended like the char Joaat adds.
+	 */
+	JOAAT_AVX2 static inline __m256i Rounds(__m256i hash, __m256i bytes)
 	{
-		joaat_t hash = 0;
-		for (auto c : str)
+		for (const auto c : {_mm256_srai_epi32(_mm256_slli_epi32(bytes, 24), 24), _mm256_srai_epi32(_mm256_slli_epi32(bytes, 16), 24),
+		         _mm256_srai_epi32(_mm256_slli_epi32(bytes, 8), 24), _mm256_srai_epi32(bytes, 24)})
 		{
-			hash += ToLower(c);
-			hash += (hash << 10);
-			hash ^= (hash >> 6);
+			hash = _mm256_add_epi32(hash, c);
+			hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 10));
+			hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 6));
 		}
-		hash += (hash << 3);
-		hash ^= (hash >> 11);
-		hash += (hash << 15);
 		return hash;
 	}
-}
\ No newline at end of file
+
+	JOAAT_AVX2 static void JoaatAVX2(std::span<const std::string_view> strings, std::span<joaat_t> hashes)
+	{
+		// a zero byte leaves a zero hash zero, strings padded with leading zeros to the longest of their group hash the same
+		// as they are, so every lane runs the same number of rounds without masking. The padding is never written anywhere,
+		// a lane reads zeros, the one word where its padding ends and the string begins, or the string in place.
+		static constexpr std::uint64_t zero = 0;
+
+		for (std::size_t first = 0; first < strings.size(); first += s_Lanes)
+		{
+			const auto count = std::min<std::size_t>(strings.size() - first, s_Lanes);
+
+			std::size_t longest = 0;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				if (strings[first + i].size() <= s_MaxLength)
+					longest = std::max<std::size_t>(longest, strings[first + i].size());
+			}
+			longest = (longest + 7) & ~std::size_t(7);
+
+			// unused lanes and strings too long for a group hash an empty string
+			std::size_t padding[s_Lanes];
+			std::uintptr_t base[s_Lanes];
+			std::uint64_t head[s_Lanes];
+			for (std::size_t i = 0; i < s_Lanes; ++i)
+			{
+				const auto str = i < count && strings[first + i].size() <= s_MaxLength ? strings[first + i] : std::string_view{};
+				padding[i]     = longest - str.size();
+				base[i]        = reinterpret_cast<std::uintptr_t>(str.data()) - padding[i];
+
+				// only read where the padding does not end on a word, which leaves at least one byte of string in it
+				const auto shift = padding[i] % sizeof(head[i]);
+				head[i]          = 0;
+				if (str.size() >= sizeof(head[i]))
+				{
+					std::memcpy(&head[i], str.data(), sizeof(head[i]));
+					head[i] = shift ? head[i] << 8 * shift : 0;
+				}
+				else
+				{
+					for (std::size_t j = 0; shift && j < sizeof(head[i]) - shift; ++j)
+						head[i] |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(str[j])) << 8 * (shift + j);
+				}
+			}
+
+			auto hash = _mm256_setzero_si256();
+			for (std::size_t position = 0; position < longest; position += sizeof(std::uint64_t))
+			{
+				std::int64_t word[s_Lanes];
+				for (std::size_t i = 0; i < s_Lanes; ++i)
+				{
+					const auto before = position + sizeof(word[i]) <= padding[i] ? &zero : &head[i];
+					const auto at     = position >= padding[i] ? base[i] + position : reinterpret_cast<std::uintptr_t>(before);
+					std::memcpy(&word[i], reinterpret_cast<const void*>(at), sizeof(word[i]));
+				}
+
+				// the low and high halves of every word, both in lane order 0 1 4 5 2 3 6 7 which the result is shuffled back from
+				const auto low  = _mm256_setr_epi64x(word[0], word[1], word[2], word[3]);
+				const auto high = _mm256_setr_epi64x(word[4], word[5], word[6], word[7]);
+				hash            = Rounds(hash, Lowercase(_mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(low), _mm256_castsi256_ps(high), 0x88))));
+				hash            = Rounds(hash, Lowercase(_mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(low), _mm256_castsi256_ps(high), 0xDD))));
+			}
+			hash = _mm256_permute4x64_epi64(hash, 0xD8);
+
+			hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 3));
+			hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 11));
+			hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 15));
+
+			alignas(32) joaat_t result[s_Lanes];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(result), hash);
+			for (std::size_t i = 0; i < count; ++i)
+				hashes[first + i] = strings[first + i].size() <= s_MaxLength ? result[i] : Joaat(strings[first + i]);
+		}
+	}
+#endif
+
+	void Joaat(std::span<const std::string_view> strings, std::span<joaat_t> hashes)
+	{
+		Joaat(strings, hashes, DetectCpuLevel());
+	}
+
+	void Joaat(std::span<const std::string_view> strings, std::span<joaat_t> hashes, CpuLevel level)
+	{
+		strings = strings.first(std::min<std::size_t>(strings.size(), hashes.size()));
+
+		switch (level)
+		{
+#ifdef JOAAT_X64
+		case CpuLevel::AVX2: return JoaatAVX2(strings, hashes);
+#endif
+		default: return JoaatScalar(strings, hashes);
+		}
+	}
+}
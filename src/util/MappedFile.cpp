@@ -0,0 +1,102 @@
+#include "MappedFile.hpp"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace NewBase
+{
+	MappedFile::MappedFile() :
+	    m_Data(nullptr),
+	    m_Size(0),
+	    m_Mapping(nullptr)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const std::filesystem::path& file)
+	{
+		Close();
+
+		const auto handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(handle, &size) || !size.QuadPart)
+		{
+			CloseHandle(handle);
+			return false;
+		}
+
+		// the view keeps the mapping alive, and the mapping the file
+		m_Mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(handle);
+		if (!m_Mapping)
+			return false;
+
+		m_Data = static_cast<const std::uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!m_Data)
+		{
+			Close();
+			return false;
+		}
+		m_Size = static_cast<std::size_t>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		if (m_Mapping)
+			CloseHandle(m_Mapping);
+
+		m_Data    = nullptr;
+		m_Size    = 0;
+		m_Mapping = nullptr;
+	}
+#else
+	bool MappedFile::Open(const std::filesystem::path& file)
+	{
+		Close();
+
+		const auto fd = open(file.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(fd, &info) || !info.st_size)
+		{
+			close(fd);
+			return false;
+		}
+
+		const auto mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED)
+			return false;
+
+		m_Data = static_cast<const std::uint8_t*>(mapping);
+		m_Size = static_cast<std::size_t>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_Data)
+			munmap(const_cast<std::uint8_t*>(m_Data), m_Size);
+
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+#endif
+}
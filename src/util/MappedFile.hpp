@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace NewBase
+{
+	/**
+	 * @brief Read only memory mapping of a whole file, pages are only read from disk once they are touched.
+	 */
+	class MappedFile
+	{
+	private:
+		const std::uint8_t* m_Data;
+		std::size_t m_Size;
+		void* m_Mapping; // file mapping object, unused where the view alone keeps the file mapped
+
+	public:
+		MappedFile();
+		~MappedFile();
+		MappedFile(const MappedFile&)            = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * @return true If the file exists, is not empty and could be mapped
+		 */
+		bool Open(const std::filesystem::path& file);
+		void Close();
+
+		std::span<const std::uint8_t> Data() const
+		{
+			return {m_Data, m_Size};
+		}
+	};
+}
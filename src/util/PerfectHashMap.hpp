@@ -0,0 +1,159 @@
+#pragma once
+#include "util/Joaat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace NewBase
+{
+	/**
+	 * @brief Read only map from joaat_t to Value whose layout is computed at compile time, a lookup is one probe.
+	 *
+	 * Keys are spread over buckets, every bucket gets the first seed that sends all of its keys to slots no other key
+	 * took yet (hash and displace). Find hashes the key into its bucket, hashes it again with the bucket's seed and
+	 * compares the single slot it lands on. Empty slots hold a key that lives in another slot, so they never match.
+	 */
+	template<typename Value, std::size_t N>
+	class PerfectHashMap
+	{
+		static_assert(N > 0, "An empty PerfectHashMap has nothing to look up.");
+
+	public:
+		using Entry = std::pair<joaat_t, Value>;
+
+	private:
+		static constexpr std::size_t s_Buckets = N / 2 + 1;
+		static constexpr std::size_t s_Slots   = N + N / 4 + 1;
+
+		std::array<std::uint32_t, s_Buckets> m_Seeds{};
+		std::array<joaat_t, s_Slots> m_Keys{};
+		std::array<Value, s_Slots> m_Values{};
+
+	public:
+		consteval PerfectHashMap(const Entry (&entries)[N]);
+
+		constexpr const Value* Find(joaat_t key) const
+		{
+			const auto slot = Slot(key, m_Seeds[Bucket(key)]);
+			return m_Keys[slot] == key ? &m_Values[slot] : nullptr;
+		}
+
+		constexpr bool Contains(joaat_t key) const
+		{
+			return Find(key);
+		}
+
+		constexpr std::size_t Size() const
+		{
+			return N;
+		}
+
+	private:
+		/**
+		 * @brief Maps a mixed hash onto [0, count) with a multiply instead of a division.
+		 */
+		static constexpr std::size_t Reduce(std::uint32_t hash, std::size_t count)
+		{
+			return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * count) >> 32);
+		}
+
+		/**
+		 * @brief Full avalanche, keys that differ in a single bit or form a sequence still land far apart.
+		 */
+		static constexpr std::uint32_t Mix(std::uint32_t hash)
+		{
+			hash ^= hash >> 16;
+			hash *= 0x7FEB352Du;
+			hash ^= hash >> 15;
+			hash *= 0x846CA68Bu;
+			hash ^= hash >> 16;
+			return hash;
+		}
+
+		static constexpr std::size_t Bucket(joaat_t key)
+		{
+			return Reduce(Mix(key), s_Buckets);
+		}
+
+		static constexpr std::size_t Slot(joaat_t key, std::uint32_t seed)
+		{
+			return Reduce(Mix(key ^ (seed + 1) * 0x9E3779B9u), s_Slots);
+		}
+	};
+
+	/**
+	 * @brief Deduces the entry count from the list, MakePerfectHashMap<unsigned int>({{"A"_J, 1}, {"B"_J, 2}}).
+	 */
+	template<typename Value, std::size_t N>
+	consteval PerfectHashMap<Value, N> MakePerfectHashMap(const std::pair<joaat_t, Value> (&entries)[N])
+	{
+		return PerfectHashMap<Value, N>(entries);
+	}
+
+	template<typename Value, std::size_t N>
+	inline consteval PerfectHashMap<Value, N>::PerfectHashMap(const Entry (&entries)[N])
+	{
+		std::array<std::array<std::size_t, N>, s_Buckets> members{};
+		std::array<std::size_t, s_Buckets> sizes{};
+		for (std::size_t i = 0; i < N; i++)
+		{
+			for (std::size_t j = 0; j < i; j++)
+			{
+				if (entries[i].first == entries[j].first)
+					throw std::invalid_argument("PerfectHashMap keys have to be unique.");
+			}
+
+			const auto bucket               = Bucket(entries[i].first);
+			members[bucket][sizes[bucket]++] = i;
+		}
+
+		// the fullest buckets are placed first while most slots are still free
+		std::array<std::size_t, s_Buckets> order{};
+		for (std::size_t i = 0; i < s_Buckets; i++)
+			order[i] = i;
+		std::ranges::sort(order, [&sizes](std::size_t a, std::size_t b) {
+			return sizes[a] != sizes[b] ? sizes[a] > sizes[b] : a < b;
+		});
+
+		std::array<bool, s_Slots> used{};
+		std::array<std::size_t, N> slots{};
+		for (const auto bucket : order)
+		{
+			if (!sizes[bucket])
+				break;
+
+			for (std::uint32_t seed = 0;; seed++)
+			{
+				if (seed == UINT32_MAX)
+					throw std::logic_error("PerfectHashMap found no seed for a bucket.");
+
+				bool placed = true;
+				for (std::size_t i = 0; i < sizes[bucket] && placed; i++)
+				{
+					slots[i] = Slot(entries[members[bucket][i]].first, seed);
+					placed   = !used[slots[i]] && std::find(slots.begin(), slots.begin() + i, slots[i]) == slots.begin() + i;
+				}
+				if (!placed)
+					continue;
+
+				m_Seeds[bucket] = seed;
+				for (std::size_t i = 0; i < sizes[bucket]; i++)
+				{
+					used[slots[i]]     = true;
+					m_Keys[slots[i]]   = entries[members[bucket][i]].first;
+					m_Values[slots[i]] = entries[members[bucket][i]].second;
+				}
+				break;
+			}
+		}
+
+		// the first key sits in a slot of its own, every empty slot can hold it without ever matching
+		for (std::size_t i = 0; i < s_Slots; i++)
+		{
+			if (!used[i])
+				m_Keys[i] = entries[0].first;
+		}
+	}
+}
@@ -0,0 +1,123 @@
+#include "WorkerPool.hpp"
+
+namespace NewBase
+{
+	WorkerPool::WorkerPool(std::size_t threads) :
+	    m_NextQueue(0),
+	    m_Queued(0),
+	    m_Pending(0),
+	    m_Stop(false)
+	{
+		// the last queue belongs to whoever calls Wait()
+		for (std::size_t i = 0; i < threads + 1; i++)
+			m_Queues.emplace_back(std::make_unique<Queue>());
+
+		for (std::size_t i = 0; i < threads; i++)
+			m_Workers.emplace_back(&WorkerPool::WorkerMain, this, i);
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard lock(m_SignalLock);
+			m_Stop = true;
+		}
+		m_Signal.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+	}
+
+	void WorkerPool::Push(std::function<void()> job)
+	{
+		{
+			std::lock_guard lock(m_SignalLock);
+			m_Queued++;
+			m_Pending++;
+		}
+
+		auto& queue = *m_Queues[m_NextQueue++ % m_Queues.size()];
+		{
+			std::lock_guard lock(queue.m_Lock);
+			queue.m_Jobs.emplace_back(std::move(job));
+		}
+		m_Signal.notify_all();
+	}
+
+	void WorkerPool::Wait()
+	{
+		const auto home = m_Queues.size() - 1;
+		while (m_Pending)
+		{
+			if (RunOne(home))
+				continue;
+
+			std::unique_lock lock(m_SignalLock);
+			m_Signal.wait(lock, [this] {
+				return !m_Pending || m_Queued;
+			});
+		}
+	}
+
+	std::size_t WorkerPool::DefaultThreads()
+	{
+		const auto hardware = std::thread::hardware_concurrency();
+		return hardware > 1 ? hardware - 1 : 0;
+	}
+
+	bool WorkerPool::RunOne(std::size_t home)
+	{
+		std::function<void()> job;
+		for (std::size_t i = 0; i < m_Queues.size() && !job; i++)
+		{
+			auto& queue = *m_Queues[(home + i) % m_Queues.size()];
+
+			std::lock_guard lock(queue.m_Lock);
+			if (queue.m_Jobs.empty())
+				continue;
+
+			// own jobs are taken in order, stolen ones from the back to stay out of the owner's way
+			if (i == 0)
+			{
+				job = std::move(queue.m_Jobs.front());
+				queue.m_Jobs.pop_front();
+			}
+			else
+			{
+				job = std::move(queue.m_Jobs.back());
+				queue.m_Jobs.pop_back();
+			}
+		}
+		if (!job)
+			return false;
+
+		m_Queued--;
+		job();
+
+		bool done;
+		{
+			std::lock_guard lock(m_SignalLock);
+			done = !--m_Pending;
+		}
+		if (done)
+			m_Signal.notify_all();
+
+		return true;
+	}
+
+	void WorkerPool::WorkerMain(std::size_t index)
+	{
+		while (true)
+		{
+			if (RunOne(index))
+				continue;
+
+			std::unique_lock lock(m_SignalLock);
+			m_Signal.wait(lock, [this] {
+				return m_Stop || m_Queued;
+			});
+			if (m_Stop)
+				return;
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NewBase
+{
+	/**
+	 * @brief Fixed-size work-stealing thread pool.
+	 * Every worker owns a queue and steals from the others once it runs dry, the thread calling Wait() helps out too.
+	 */
+	class WorkerPool
+	{
+	private:
+		struct Queue
+		{
+			std::mutex m_Lock;
+			std::deque<std::function<void()>> m_Jobs;
+		};
+
+		std::vector<std::unique_ptr<Queue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+		std::atomic<std::size_t> m_NextQueue;
+		std::atomic<std::size_t> m_Queued;
+		std::atomic<std::size_t> m_Pending;
+		std::mutex m_SignalLock;
+		std::condition_variable m_Signal;
+		bool m_Stop;
+
+	public:
+		/**
+		 * @param threads Amount of worker threads to spawn, 0 runs every job on the thread calling Wait().
+		 */
+		explicit WorkerPool(std::size_t threads);
+		~WorkerPool();
+		WorkerPool(const WorkerPool&)                = delete;
+		WorkerPool(WorkerPool&&) noexcept            = delete;
+		WorkerPool& operator=(const WorkerPool&)     = delete;
+		WorkerPool& operator=(WorkerPool&&) noexcept = delete;
+
+		/**
+		 * @brief Workers plus the thread calling Wait().
+		 */
+		std::size_t Concurrency() const
+		{
+			return m_Workers.size() + 1;
+		}
+
+		void Push(std::function<void()> job);
+		/**
+		 * @brief Runs jobs on the calling thread until every pushed job has completed.
+		 */
+		void Wait();
+
+		/**
+		 * @brief Sensible worker count for a pool that should use the whole machine alongside the calling thread.
+		 */
+		static std::size_t DefaultThreads();
+
+	private:
+		bool RunOne(std::size_t home);
+		void WorkerMain(std::size_t index);
+	};
+}
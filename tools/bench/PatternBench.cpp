@@ -0,0 +1,343 @@
+#include "SyntheticImage.hpp"
+#include "memory/Module.hpp"
+#include "memory/MultiScanKernel.hpp"
+#include "memory/PatternScanner.hpp"
+#include "memory/SuffixIndex.hpp"
+#include "memory/XrefIndex.hpp"
+#include "pointers/Signatures.hpp"
+#include "util/Joaat.hpp"
+#include "util/WorkerPool.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+
+using namespace NewBase;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Resolves every given pattern inside the module once, returns the lowest match per pattern.
+	 */
+	using StrategyFunc = std::function<std::vector<std::uintptr_t>(const Module& module, std::span<const IPattern* const> patterns)>;
+
+	struct Strategy
+	{
+		std::string_view m_Name;
+		StrategyFunc m_Run;
+	};
+
+	struct Options
+	{
+		std::size_t m_MinSize     = 1 << 20;
+		std::size_t m_MaxSize     = 128 << 20;
+		std::size_t m_Repetitions = 5;
+		std::uint64_t m_Seed      = 0x59494D41;
+		std::string_view m_Filter;
+		bool m_Verbose            = false;
+	};
+
+	constexpr auto missing = Pattern<"0F 0B ? 13 37 C0 DE 0F 0B">("Missing");
+
+	constexpr std::array<const IPattern*, 11> s_Patterns = {&Signatures::QueueDependency, &Signatures::InitMemAllocator, &Signatures::SMPACreateStub, &Signatures::ReadGameConfig, &Signatures::GetPoolSize, &Signatures::CreatePool, &Signatures::GetPoolItem, &Signatures::OnlineCheck, &Signatures::PoolStuff, &Signatures::PoolStuff2, &missing};
+
+	std::span<const std::uint8_t> Text(const Module& module)
+	{
+		const auto text = module.GetSection(".text");
+		return {reinterpret_cast<const std::uint8_t*>(module.Base() + text->m_Rva), text->m_Size};
+	}
+
+	StrategyFunc KernelStrategy(ScanKernel::Level level)
+	{
+		return [level](const Module& module, std::span<const IPattern* const> patterns) {
+			const auto text = Text(module);
+
+			std::vector<std::uintptr_t> results;
+			for (const auto pattern : patterns)
+			{
+				const auto match = ScanKernel::Find(text.data(), text.data() + text.size(), pattern->Signature(), level);
+				results.push_back(reinterpret_cast<std::uintptr_t>(match));
+			}
+			return results;
+		};
+	}
+
+	std::vector<std::uintptr_t> MultiStrategy(const Module& module, std::span<const IPattern* const> patterns)
+	{
+		const auto text = Text(module);
+
+		std::vector<ScanSignature> signatures;
+		for (const auto pattern : patterns)
+			signatures.push_back(pattern->Signature());
+
+		std::vector<const std::uint8_t*> found(patterns.size());
+		MultiScanKernel(std::move(signatures)).FindFirst(text.data(), text.data() + text.size(), found);
+
+		std::vector<std::uintptr_t> results;
+		for (const auto match : found)
+			results.push_back(reinterpret_cast<std::uintptr_t>(match));
+		return results;
+	}
+
+	std::vector<std::uintptr_t> ScannerStrategy(const Module& module, std::span<const IPattern* const> patterns)
+	{
+		std::vector<std::uintptr_t> results(patterns.size());
+
+		PatternScanner scanner(&module);
+		for (std::size_t i = 0; i < patterns.size(); ++i)
+		{
+			scanner.Add(*patterns[i], [&results, i](PointerCalculator ptr) {
+				results[i] = ptr.As<std::uintptr_t>();
+			});
+		}
+		scanner.Scan();
+		return results;
+	}
+
+	std::vector<std::uintptr_t> FindAllStrategy(const Module& module, std::span<const IPattern* const> patterns)
+	{
+		PatternScanner scanner(&module);
+		for (const auto pattern : patterns)
+			scanner.Add(*pattern, [](PointerCalculator) {
+			});
+
+		std::vector<std::uintptr_t> results;
+		for (const auto& match : scanner.FindAll(1))
+			results.push_back(match.m_Addresses.empty() ? 0 : match.m_Addresses.front());
+		return results;
+	}
+
+	std::vector<Strategy> Strategies()
+	{
+		std::vector<Strategy> strategies = {{"scalar", KernelStrategy(ScanKernel::Level::Scalar)}};
+		if (ScanKernel::Detect() >= ScanKernel::Level::SSE2)
+			strategies.push_back({"sse2", KernelStrategy(ScanKernel::Level::SSE2)});
+		if (ScanKernel::Detect() >= ScanKernel::Level::AVX2)
+			strategies.push_back({"avx2", KernelStrategy(ScanKernel::Level::AVX2)});
+
+		strategies.push_back({"multi", MultiStrategy});
+		strategies.push_back({"scanner", ScannerStrategy});
+		strategies.push_back({"findall", FindAllStrategy});
+		return strategies;
+	}
+
+	/**
+	 * @brief Median wall time of the repetitions in seconds.
+	 */
+	template<typename F>
+	double Measure(std::size_t repetitions, F&& func)
+	{
+		std::vector<double> times;
+		for (std::size_t i = 0; i < repetitions; ++i)
+		{
+			const auto start = Clock::now();
+			func();
+			times.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+		}
+		std::ranges::sort(times);
+		return times[times.size() / 2];
+	}
+
+	void PrintRow(std::string_view strategy, std::string_view pattern, std::size_t size, double seconds)
+	{
+		std::cout << std::left << std::setw(10) << strategy << std::setw(18) << pattern << std::right << std::setw(8) << (size >> 20) << " MiB"
+		          << std::fixed << std::setprecision(3) << std::setw(12) << seconds * 1e3 << " ms" << std::setw(10)
+		          << static_cast<double>(size) / seconds / 1e9 << " GB/s\n";
+	}
+
+	bool BenchmarkImage(const Options& options, std::size_t size)
+	{
+		SyntheticImage image(size, options.m_Seed);
+
+		// spread the patterns over the image so the first match scans cover different distances, the last one is never planted
+		const auto text = image.Size() - SyntheticImage::s_TextRva;
+		for (std::size_t i = 0; i + 1 < s_Patterns.size(); ++i)
+		{
+			const auto rva = SyntheticImage::s_TextRva + text / s_Patterns.size() * (i + 1);
+			image.Plant(*s_Patterns[i], static_cast<std::uint32_t>(rva));
+		}
+
+		Module module(image.Entry());
+
+		bool consistent = true;
+		std::vector<std::uintptr_t> reference;
+		std::string_view referenceName;
+		for (const auto& strategy : Strategies())
+		{
+			if (!options.m_Filter.empty() && strategy.m_Name != options.m_Filter)
+				continue;
+
+			std::vector<std::uintptr_t> results;
+			const auto total = Measure(options.m_Repetitions, [&] {
+				results = strategy.m_Run(module, s_Patterns);
+			});
+			PrintRow(strategy.m_Name, "<all>", image.Size(), total);
+
+			if (referenceName.empty())
+			{
+				reference     = results;
+				referenceName = strategy.m_Name;
+			}
+			else if (results != reference)
+			{
+				std::cout << "  results of " << strategy.m_Name << " differ from " << referenceName << "\n";
+				consistent = false;
+			}
+
+			for (const auto pattern : s_Patterns)
+			{
+				const auto latency = Measure(options.m_Repetitions, [&] {
+					strategy.m_Run(module, std::span(&pattern, 1));
+				});
+				PrintRow(strategy.m_Name, pattern->Name(), image.Size(), latency);
+			}
+		}
+
+		if (options.m_Filter.empty() || options.m_Filter == "xref")
+		{
+			XrefIndex index;
+			const auto build = Measure(options.m_Repetitions, [&] {
+				index.Build(module);
+			});
+			PrintRow("xref", "<build>", image.Size(), build);
+		}
+
+		if (options.m_Filter.empty() || options.m_Filter == "suffix")
+		{
+			// building takes seconds at the larger sizes, once is enough
+			SuffixIndex index;
+			const auto build = Measure(1, [&] {
+				index.Build(module);
+			});
+			PrintRow("suffix", "<build>", image.Size(), build);
+
+			std::vector<std::uintptr_t> results;
+			const auto query = Measure(options.m_Repetitions, [&] {
+				results.clear();
+				for (const auto pattern : s_Patterns)
+					results.push_back(reinterpret_cast<std::uintptr_t>(index.FindFirst(*pattern)));
+			});
+			PrintRow("suffix", "<all>", image.Size(), query);
+
+			if (!referenceName.empty() && results != reference)
+			{
+				std::cout << "  results of suffix differ from " << referenceName << "\n";
+				consistent = false;
+			}
+		}
+		return consistent;
+	}
+
+	bool BenchmarkJoaat(const Options& options)
+	{
+		std::mt19937_64 rng(options.m_Seed);
+		std::vector<std::string> names(1 << 16);
+		for (auto& name : names)
+		{
+			name.resize(8 + rng() % 24);
+			for (auto& c : name)
+				c = "abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"[rng() % 63];
+		}
+
+		std::size_t bytes = 0;
+		for (const auto& name : names)
+			bytes += name.size();
+
+		const auto printRow = [&](std::string_view strategy, double seconds, joaat_t sink) {
+			std::cout << std::left << std::setw(10) << strategy << std::setw(18) << "<names>" << std::right << std::fixed << std::setprecision(1)
+			          << std::setw(12) << seconds / names.size() * 1e9 << " ns/hash" << std::setprecision(3) << std::setw(10)
+			          << static_cast<double>(bytes) / seconds / 1e9 << " GB/s (" << HEX(sink) << ")\n";
+		};
+
+		joaat_t sink       = 0;
+		const auto seconds = Measure(options.m_Repetitions, [&] {
+			for (const auto& name : names)
+				sink ^= Joaat(name);
+		});
+		printRow("joaat", seconds, sink);
+
+		std::vector<joaat_t> reference(names.size());
+		for (std::size_t i = 0; i < names.size(); ++i)
+			reference[i] = Joaat(names[i]);
+
+		const std::vector<std::string_view> views(names.begin(), names.end());
+		std::vector<joaat_t> hashes(names.size());
+		bool consistent = true;
+		for (const auto& [name, level] : {std::pair{"batch", ScanKernel::Level::Scalar}, std::pair{"batch-avx2", ScanKernel::Level::AVX2}})
+		{
+			if (level > ScanKernel::Detect())
+				continue;
+
+			const auto batch = Measure(options.m_Repetitions, [&] {
+				Joaat(views, hashes, level);
+			});
+			printRow(name, batch, hashes.back());
+
+			if (hashes != reference)
+			{
+				std::cout << "  hashes of " << name << " differ from joaat\n";
+				consistent = false;
+			}
+		}
+		return consistent;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--verbose")
+			{
+				options.m_Verbose = true;
+				continue;
+			}
+			if (i + 1 >= argc)
+				return false;
+
+			const std::string_view value = argv[++i];
+			if (arg == "--min-mb")
+				options.m_MinSize = std::stoull(std::string(value)) << 20;
+			else if (arg == "--max-mb")
+				options.m_MaxSize = std::stoull(std::string(value)) << 20;
+			else if (arg == "--reps")
+				options.m_Repetitions = std::max<std::size_t>(std::stoull(std::string(value)), 1);
+			else if (arg == "--seed")
+				options.m_Seed = std::stoull(std::string(value), nullptr, 0);
+			else if (arg == "--strategy")
+				options.m_Filter = value;
+			else
+				return false;
+		}
+		return options.m_MinSize && options.m_MinSize <= options.m_MaxSize;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "usage: " << argv[0] << " [--min-mb 1] [--max-mb 128] [--reps 5] [--seed 0x59494D41] [--strategy scalar|sse2|avx2|multi|scanner|findall|xref|suffix] [--verbose]\n";
+		return 2;
+	}
+
+	// the never planted pattern would report a failed scan on every repetition
+	al::LogThreshold() = options.m_Verbose ? al::eLogLevel::INFO : al::eLogLevel::SILENT;
+
+	std::cout << "kernel level " << static_cast<int>(ScanKernel::Detect()) << ", " << WorkerPool::DefaultThreads() + 1 << " threads\n";
+
+	std::vector<std::size_t> sizes;
+	for (auto size = options.m_MinSize; size < options.m_MaxSize; size *= 4)
+		sizes.push_back(size);
+	sizes.push_back(options.m_MaxSize);
+
+	bool consistent = true;
+	for (const auto size : sizes)
+		consistent &= BenchmarkImage(options, size);
+
+	consistent &= BenchmarkJoaat(options);
+	return consistent ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include "SyntheticImage.hpp"
+
+#include <random>
+
+namespace NewBase
+{
+	SyntheticImage::SyntheticImage(std::size_t size, std::uint64_t seed) :
+	    m_Data(std::max<std::size_t>(size, s_TextRva * 2)),
+	    m_Path(L"C:\\Synthetic\\GTA5.exe"),
+	    m_Entry()
+	{
+		WriteHeaders();
+		WriteCode(seed);
+
+		m_Entry.DllBase            = m_Data.data();
+		m_Entry.FullDllName.Buffer = m_Path.data();
+	}
+
+	void SyntheticImage::Plant(const IPattern& pattern, std::uint32_t rva)
+	{
+		const auto& signature = pattern.Signature();
+		for (std::size_t i = 0; i < signature.Size(); ++i)
+		{
+			if (signature.m_Masks[i])
+				m_Data[rva + i] = signature.m_Values[i];
+		}
+	}
+
+	void SyntheticImage::WriteHeaders()
+	{
+		const auto dos = reinterpret_cast<IMAGE_DOS_HEADER*>(m_Data.data());
+		dos->e_magic   = IMAGE_DOS_SIGNATURE;
+		dos->e_lfanew  = 0x80;
+
+		const auto nt                             = reinterpret_cast<IMAGE_NT_HEADERS*>(m_Data.data() + dos->e_lfanew);
+		nt->Signature                             = IMAGE_NT_SIGNATURE;
+		nt->FileHeader.NumberOfSections           = 1;
+		nt->FileHeader.SizeOfOptionalHeader       = sizeof(IMAGE_OPTIONAL_HEADER64);
+		nt->FileHeader.TimeDateStamp              = 0x5EEDC0DE;
+		nt->OptionalHeader.Magic                  = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+		nt->OptionalHeader.SizeOfImage            = static_cast<DWORD>(m_Data.size());
+		nt->OptionalHeader.SizeOfHeaders          = s_TextRva;
+		nt->OptionalHeader.NumberOfRvaAndSizes    = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+
+		const auto text        = IMAGE_FIRST_SECTION(nt);
+		text->VirtualAddress   = s_TextRva;
+		text->Misc.VirtualSize = static_cast<DWORD>(m_Data.size() - s_TextRva);
+		text->SizeOfRawData    = text->Misc.VirtualSize;
+		text->Characteristics  = IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ;
+		std::memcpy(text->Name, ".text", 5);
+	}
+
+	void SyntheticImage::WriteCode(std::uint64_t seed)
+	{
+		// instruction shaped fragments weighted after what MSVC emits, a ? is filled with a random byte
+		static constexpr std::pair<std::string_view, int> fragments[] = {
+		    {"48 8B ? ?", 14},
+		    {"48 89 ? 24 ?", 10},
+		    {"E8 ? ? ? ?", 9},
+		    {"48 8D ? ? ? ? ?", 7},
+		    {"8B ? ?", 6},
+		    {"89 ? ?", 5},
+		    {"33 C0", 4},
+		    {"48 83 EC ?", 3},
+		    {"48 83 C4 ?", 3},
+		    {"85 C0", 4},
+		    {"74 ?", 5},
+		    {"75 ?", 4},
+		    {"0F 84 ? ? ? ?", 3},
+		    {"E9 ? ? ? ?", 2},
+		    {"41 ? ?", 4},
+		    {"4C 8B ? ?", 4},
+		    {"C3", 2},
+		    {"CC CC CC CC", 1},
+		    {"? ? ?", 6},
+		};
+
+		std::vector<int> weights;
+		for (const auto& [fragment, weight] : fragments)
+			weights.push_back(weight);
+
+		std::mt19937_64 rng(seed);
+		std::discrete_distribution<std::size_t> pick(weights.begin(), weights.end());
+
+		auto out       = m_Data.begin() + s_TextRva;
+		const auto end = m_Data.end();
+		while (out != end)
+		{
+			const auto fragment = fragments[pick(rng)].first;
+			for (std::size_t i = 0; i < fragment.size() && out != end; i += 3)
+			{
+				if (fragment[i] == '?')
+					*out++ = static_cast<std::uint8_t>(rng());
+				else
+					*out++ = static_cast<std::uint8_t>(StrToHex(fragment[i]) * 0x10 + StrToHex(fragment[i + 1]));
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "memory/Pattern.hpp"
+
+#include <winternl.h>
+
+namespace NewBase
+{
+	/**
+	 * @brief Deterministic PE image in memory whose .text section looks roughly like compiled x86-64 code.
+	 * The same seed and size always produce the same bytes, so numbers from different runs can be compared.
+	 */
+	class SyntheticImage final
+	{
+	private:
+		std::vector<std::uint8_t> m_Data;
+		std::wstring m_Path;
+		LDR_DATA_TABLE_ENTRY m_Entry;
+
+	public:
+		static constexpr std::uint32_t s_TextRva = 0x1000;
+
+		SyntheticImage(std::size_t size, std::uint64_t seed);
+
+		/**
+		 * @brief Writes the pattern at the RVA, wildcards keep the generated bytes underneath.
+		 */
+		void Plant(const IPattern& pattern, std::uint32_t rva);
+
+		const std::uint8_t* Data() const
+		{
+			return m_Data.data();
+		}
+		std::size_t Size() const
+		{
+			return m_Data.size();
+		}
+		/**
+		 * @brief Loader entry the image can be handed to a Module with.
+		 */
+		LDR_DATA_TABLE_ENTRY* Entry()
+		{
+			return &m_Entry;
+		}
+
+	private:
+		void WriteHeaders();
+		void WriteCode(std::uint64_t seed);
+	};
+}
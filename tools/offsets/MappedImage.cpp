@@ -0,0 +1,47 @@
+#include "MappedImage.hpp"
+
+#include "memory/PEImage.hpp"
+#include "util/MappedFile.hpp"
+
+namespace NewBase
+{
+	bool MappedImage::Load(const std::filesystem::path& file)
+	{
+		MappedFile mapping;
+		if (!mapping.Open(file))
+		{
+			LOG(FATAL) << "Failed to map " << file.string();
+			return false;
+		}
+
+		const auto mapped = Map(mapping.Data().data(), mapping.Data().size());
+		if (!mapped)
+		{
+			LOG(FATAL) << file.string() << " is not a PE32+ image.";
+		}
+		return mapped;
+	}
+
+	bool MappedImage::Map(const std::uint8_t* file, std::size_t size)
+	{
+		const PEImage image({file, size}, PEImage::Layout::File);
+		if (!image.Valid())
+			return false;
+
+		m_Image.assign(image.SizeOfImage(), 0);
+
+		const auto headers = std::min<std::size_t>({image.NtHeader()->OptionalHeader.SizeOfHeaders, size, m_Image.size()});
+		std::memcpy(m_Image.data(), file, headers);
+
+		for (const auto& section : image.Sections())
+		{
+			if (section.VirtualAddress >= m_Image.size())
+				continue;
+
+			// whatever the file holds of the section, the rest of it stays zeroed
+			const auto data = image.SectionData(section);
+			std::memcpy(m_Image.data() + section.VirtualAddress, data.data(), std::min<std::size_t>(data.size(), m_Image.size() - section.VirtualAddress));
+		}
+		return true;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace NewBase
+{
+	/**
+	 * @brief A PE file from disk laid out the way the Windows loader would map it, every section at its RVA.
+	 * Relocations and imports are left alone, RVAs and RIP relative operands are all the scanner needs.
+	 */
+	class MappedImage final
+	{
+	private:
+		std::vector<std::uint8_t> m_Image;
+
+	public:
+		/**
+		 * @brief Memory maps the file and copies its headers and sections into place.
+		 *
+		 * @return true If the file is a well formed PE32+ image
+		 */
+		bool Load(const std::filesystem::path& file);
+
+		std::uintptr_t Base() const
+		{
+			return reinterpret_cast<std::uintptr_t>(m_Image.data());
+		}
+		std::size_t Size() const
+		{
+			return m_Image.size();
+		}
+
+	private:
+		bool Map(const std::uint8_t* file, std::size_t size);
+	};
+}
@@ -0,0 +1,138 @@
+#include "MappedImage.hpp"
+#include "memory/Module.hpp"
+#include "memory/PatternCache.hpp"
+#include "memory/PatternScanner.hpp"
+#include "pointers/Signatures.hpp"
+#include "util/Joaat.hpp"
+
+#include <span>
+
+using namespace NewBase;
+
+namespace
+{
+	struct Options
+	{
+		std::filesystem::path m_Output;
+		std::vector<std::filesystem::path> m_Inputs;
+		std::string_view m_Set;
+	};
+
+	/**
+	 * @brief Signatures Pointers resolves inside the given module, picked by file name unless a set is forced.
+	 */
+	std::span<const PointerSignature> SignatureSet(const std::filesystem::path& file, std::string_view set)
+	{
+		const auto name = Joaat(file.filename().string());
+
+		if (set == "game" || (set.empty() && name == "GTA5.exe"_J))
+			return Signatures::Game;
+		if (set == "scripthook" || (set.empty() && name == "ScriptHookV.dll"_J))
+			return Signatures::ScriptHook;
+		return {};
+	}
+
+	/**
+	 * @brief Scans one image and adds its build block to the output table.
+	 *
+	 * @return true If every signature resolved
+	 */
+	bool ProcessImage(const std::filesystem::path& file, const Options& options)
+	{
+		const auto signatures = SignatureSet(file, options.m_Set);
+		if (signatures.empty())
+		{
+			LOG(FATAL) << "No signature set for " << file.string() << ", pass --set game|scripthook.";
+			return false;
+		}
+
+		MappedImage image;
+		if (!image.Load(file))
+			return false;
+
+		const Module module(file, image.Base());
+		const auto identity = module.Identity();
+
+		std::vector<const std::uint8_t*> matches(signatures.size());
+
+		PatternScanner scanner(&module);
+		for (std::size_t i = 0; i < signatures.size(); ++i)
+		{
+			scanner.Add(*signatures[i].m_Pattern, [&matches, i](PointerCalculator ptr) {
+				matches[i] = ptr.As<const std::uint8_t*>();
+			});
+		}
+		const auto found = scanner.Scan();
+
+		const auto output = options.m_Output.empty() ? std::filesystem::path(file.filename().string() + ".offsets") : options.m_Output;
+		PatternCache table(output, identity);
+		table.Load();
+
+		std::cout << file.string() << ": build " << PatternCache::FormatIdentity(identity) << '\n';
+		for (std::size_t i = 0; i < signatures.size(); ++i)
+		{
+			const auto name = signatures[i].m_Pattern->Name();
+			if (!matches[i])
+			{
+				std::cout << "  " << name << " not found\n";
+				continue;
+			}
+
+			// the loader reapplies the arithmetic to the verified match, the resolved RVA is only printed for reference
+			const auto rva      = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(matches[i]) - module.Base());
+			const auto resolved = signatures[i].m_Resolve(matches[i]).As<std::uintptr_t>() - module.Base();
+			table.Set(name, rva);
+			if (resolved >= module.Size())
+				std::cout << "  " << name << " resolves outside of the image\n";
+			else
+				std::cout << "  " << name << ' ' << HEX(rva) << " -> " << HEX(resolved) << '\n';
+		}
+
+		if (!table.Save())
+			return false;
+
+		std::cout << "  written to " << output.string() << '\n';
+		return found;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "-o" || arg == "--output" || arg == "--set")
+			{
+				if (i + 1 >= argc)
+					return false;
+
+				if (arg == "--set")
+					options.m_Set = argv[++i];
+				else
+					options.m_Output = argv[++i];
+				continue;
+			}
+			if (arg.starts_with('-'))
+				return false;
+
+			options.m_Inputs.emplace_back(arg);
+		}
+		return !options.m_Inputs.empty();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "usage: " << argv[0] << " [-o table.offsets] [--set game|scripthook] <GTA5.exe|ScriptHookV.dll>...\n"
+		          << "Resolves every signature Pointers uses and adds a build block per image to the offsets table, blocks of other builds are kept.\n";
+		return 2;
+	}
+
+	bool success = true;
+	for (const auto& input : options.m_Inputs)
+		success &= ProcessImage(input, options);
+
+	return success ? 0 : 1;
+}
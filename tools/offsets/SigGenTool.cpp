@@ -0,0 +1,94 @@
+#include "MappedImage.hpp"
+#include "memory/Module.hpp"
+#include "memory/SignatureGenerator.hpp"
+#include "memory/SuffixIndex.hpp"
+#include "memory/XrefIndex.hpp"
+
+using namespace NewBase;
+
+namespace
+{
+	struct Options
+	{
+		std::filesystem::path m_Input;
+		std::vector<std::uint32_t> m_Targets;
+		std::string_view m_Name = "Generated";
+		std::size_t m_MaxLength = 64;
+		bool m_Xrefs            = true;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--name" || arg == "--max-length")
+			{
+				if (i + 1 >= argc)
+					return false;
+
+				if (arg == "--name")
+					options.m_Name = argv[++i];
+				else
+					options.m_MaxLength = std::stoul(argv[++i]);
+				continue;
+			}
+			if (arg == "--no-xrefs")
+			{
+				options.m_Xrefs = false;
+				continue;
+			}
+			if (arg.starts_with('-'))
+				return false;
+
+			if (options.m_Input.empty())
+				options.m_Input = arg;
+			else
+				options.m_Targets.push_back(static_cast<std::uint32_t>(std::stoul(std::string(arg), nullptr, 16)));
+		}
+		return !options.m_Input.empty() && !options.m_Targets.empty();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "usage: " << argv[0] << " [--name Name] [--max-length 64] [--no-xrefs] <image> <rva>...\n"
+		          << "Writes the shortest unique signature leading back to every RVA (hex), directly or through the instructions referring to it.\n";
+		return 2;
+	}
+
+	MappedImage image;
+	if (!image.Load(options.m_Input))
+		return 1;
+
+	const Module module(options.m_Input, image.Base());
+
+	SuffixIndex index;
+	index.Build(module);
+
+	XrefIndex xrefs;
+	if (options.m_Xrefs)
+		xrefs.Build(module);
+
+	SignatureGenerator generator(module, index, options.m_Xrefs ? &xrefs : nullptr);
+	generator.SetMaxLength(options.m_MaxLength);
+
+	bool success = true;
+	for (const auto target : options.m_Targets)
+	{
+		const auto signature = generator.Generate(module.Base() + target);
+		if (!signature)
+		{
+			std::cout << HEX(target) << ": no unique signature within reach\n";
+			success = false;
+			continue;
+		}
+
+		std::cout << HEX(target) << ": " << signature->Literal(options.m_Name) << '\n'
+		          << "  matches at " << HEX(signature->m_Match - module.Base()) << ", resolve with match" << (signature->m_Resolve.empty() ? "" : signature->m_Resolve) << '\n';
+	}
+	return success ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#pragma once
+// Synchronous stand-in for AsyncLogger, writes everything at or above the active level to stderr.
+#include <iostream>
+#include <sstream>
+
+namespace al
+{
+	enum class eLogLevel
+	{
+		VERBOSE,
+		INFO,
+		WARNING,
+		FATAL,
+		SILENT // host only, as a threshold it drops every message
+	};
+
+	inline eLogLevel& LogThreshold()
+	{
+		static eLogLevel level = eLogLevel::WARNING;
+		return level;
+	}
+
+	class LogStream final
+	{
+	private:
+		eLogLevel m_Level;
+		std::ostringstream m_Stream;
+
+	public:
+		explicit LogStream(eLogLevel level) :
+		    m_Level(level)
+		{
+		}
+
+		~LogStream()
+		{
+			if (m_Level >= LogThreshold())
+				std::cerr << m_Stream.str() << '\n';
+		}
+
+		template<typename T>
+		LogStream& operator<<(const T& value)
+		{
+			m_Stream << value;
+			return *this;
+		}
+
+		LogStream& operator<<(std::ostream& (*manip)(std::ostream&))
+		{
+			m_Stream << manip;
+			return *this;
+		}
+
+		LogStream& operator<<(std::ios_base& (*manip)(std::ios_base&))
+		{
+			m_Stream << manip;
+			return *this;
+		}
+	};
+}
+
+#define LOG(level) ::al::LogStream(::al::eLogLevel::level)
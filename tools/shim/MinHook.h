@@ -0,0 +1,2 @@
+#pragma once
+// Intentionally empty, nothing built on this host installs hooks.
@@ -0,0 +1,30 @@
+#pragma once
+// Loader structures used by Module, laid out like the documented parts of <winternl.h>.
+#include "Windows.h"
+
+struct LIST_ENTRY
+{
+	LIST_ENTRY* Flink;
+	LIST_ENTRY* Blink;
+};
+
+struct UNICODE_STRING
+{
+	USHORT Length;
+	USHORT MaximumLength;
+	PWSTR Buffer;
+};
+
+struct LDR_DATA_TABLE_ENTRY
+{
+	PVOID Reserved1[2];
+	LIST_ENTRY InMemoryOrderLinks;
+	PVOID Reserved2[2];
+	PVOID DllBase;
+	PVOID Reserved3[2];
+	UNICODE_STRING FullDllName;
+	BYTE Reserved4[8];
+	PVOID Reserved5[3];
+	ULONG CheckSum;
+	ULONG TimeDateStamp;
+};